@@ -0,0 +1,30 @@
+/* Copyright 2020 Semantic Weights. All rights reserved. */
+
+#include "benchmark/benchmark.h"
+#include "src/cards.h"
+
+namespace tarok {
+
+void BM_DealCards(benchmark::State& bm_state) {
+  int num_players = bm_state.range(0);
+  int seed = 0;
+  for (auto _ : bm_state) {
+    auto dealt_cards = DealCards(num_players, seed++);
+    benchmark::DoNotOptimize(dealt_cards);
+  }
+  bm_state.SetItemsProcessed(bm_state.iterations());
+}
+BENCHMARK(BM_DealCards)->Arg(3)->Arg(4);
+
+void BM_DealCardSets(benchmark::State& bm_state) {
+  int num_players = bm_state.range(0);
+  int seed = 0;
+  for (auto _ : bm_state) {
+    auto dealt_cards = DealCardSets(num_players, seed++);
+    benchmark::DoNotOptimize(dealt_cards);
+  }
+  bm_state.SetItemsProcessed(bm_state.iterations());
+}
+BENCHMARK(BM_DealCardSets)->Arg(3)->Arg(4);
+
+}  // namespace tarok
@@ -0,0 +1,77 @@
+/* Copyright 2020 Semantic Weights. All rights reserved. */
+
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "src/determinization_sampler.h"
+#include "src/game.h"
+
+namespace tarok {
+
+// random states of the given number of players after the given number of
+// cards were played in tricks, i.e. 0 means right before the first trick
+static std::vector<std::unique_ptr<TarokState>> RandomStates(int num_players,
+                                                             int num_played) {
+  auto game = NewTarokGame(open_spiel::GameParameters(
+      {{"num_players", open_spiel::GameParameter(num_players)},
+       {"seed", open_spiel::GameParameter(0)}}));
+  std::mt19937 rng(0);
+  std::vector<std::unique_ptr<TarokState>> states;
+  while (states.size() < 16) {
+    auto state = game->NewInitialTarokState();
+    int num_cards = 0;
+    while (!state->IsTerminal() &&
+           (state->CurrentGamePhase() != GamePhase::kTricksPlaying ||
+            num_cards < num_played)) {
+      if (state->CurrentGamePhase() == GamePhase::kTricksPlaying) num_cards++;
+      auto legal_actions = state->LegalActions();
+      state->ApplyTrustedAction(legal_actions.at(rng() % legal_actions.size()));
+    }
+    if (!state->IsTerminal()) states.push_back(std::move(state));
+  }
+  return states;
+}
+
+// numbers of players and cards played in tricks
+void PlayersAndPlayedCardsArgs(benchmark::internal::Benchmark* benchmark) {
+  benchmark->Args({3, 0})->Args({3, 12})->Args({3, 30});
+  benchmark->Args({4, 0})->Args({4, 24});
+}
+
+void BM_DeterminizationSamplerCreate(benchmark::State& bm_state) {
+  auto states = RandomStates(bm_state.range(0), bm_state.range(1));
+  int i = 0;
+  for (auto _ : bm_state) {
+    const TarokState& state = *states[i++ % states.size()];
+    DeterminizationSampler sampler(state, state.CurrentPlayer());
+    benchmark::DoNotOptimize(sampler);
+  }
+  bm_state.SetItemsProcessed(bm_state.iterations());
+}
+
+// resamples the hidden cards into the same state over and over again, which
+// is the way searches with many determinizations are meant to use the sampler
+void BM_DeterminizationSamplerResample(benchmark::State& bm_state) {
+  auto states = RandomStates(bm_state.range(0), bm_state.range(1));
+  std::vector<DeterminizationSampler> samplers;
+  std::vector<std::unique_ptr<TarokState>> sampled_states;
+  std::mt19937 rng(0);
+  for (auto const& state : states) {
+    samplers.emplace_back(*state, state->CurrentPlayer());
+    sampled_states.push_back(samplers.back().Sample(&rng));
+  }
+  int i = 0;
+  for (auto _ : bm_state) {
+    int index = i++ % states.size();
+    samplers[index].Resample(&rng, sampled_states[index].get());
+  }
+  bm_state.SetItemsProcessed(bm_state.iterations());
+}
+
+BENCHMARK(BM_DeterminizationSamplerCreate)->Apply(PlayersAndPlayedCardsArgs);
+BENCHMARK(BM_DeterminizationSamplerResample)
+    ->Apply(PlayersAndPlayedCardsArgs);
+
+}  // namespace tarok
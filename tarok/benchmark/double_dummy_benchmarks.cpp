@@ -0,0 +1,55 @@
+/* Copyright 2020 Semantic Weights. All rights reserved. */
+
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "src/double_dummy.h"
+#include "src/game.h"
+
+namespace tarok {
+
+// solves endgames of random games where every player holds the given number
+// of cards, note that solving times grow exponentially with the number of
+// cards and vary a lot between deals
+void BM_DoubleDummySolve(benchmark::State& bm_state) {
+  int num_players = bm_state.range(0);
+  size_t num_cards = bm_state.range(1);
+  auto game = NewTarokGame(open_spiel::GameParameters(
+      {{"num_players", open_spiel::GameParameter(num_players)},
+       {"seed", open_spiel::GameParameter(0)}}));
+  std::mt19937 rng(0);
+  std::vector<std::unique_ptr<TarokState>> states;
+  while (states.size() < 8) {
+    auto state = game->NewInitialTarokState();
+    while (!state->IsTerminal() &&
+           (state->CurrentGamePhase() != GamePhase::kTricksPlaying ||
+            !state->TrickCards().empty() ||
+            state->PlayerCards(0).size() > num_cards)) {
+      auto legal_actions = state->LegalActions();
+      state->ApplyTrustedAction(legal_actions.at(rng() % legal_actions.size()));
+    }
+    if (!state->IsTerminal()) states.push_back(std::move(state));
+  }
+
+  DoubleDummySolver solver;
+  int i = 0;
+  for (auto _ : bm_state) {
+    const TarokState& state = *states[i++ % states.size()];
+    benchmark::DoNotOptimize(solver.Solve(state, state.CurrentPlayer()));
+  }
+  bm_state.SetItemsProcessed(bm_state.iterations());
+  bm_state.counters["nodes_per_second"] = benchmark::Counter(
+      solver.NumNodes(), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_DoubleDummySolve)
+    ->Args({3, 4})
+    ->Args({3, 6})
+    ->Args({3, 8})
+    ->Args({4, 4})
+    ->Args({4, 6})
+    ->Args({4, 8});
+
+}  // namespace tarok
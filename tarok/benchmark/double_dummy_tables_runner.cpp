@@ -0,0 +1,77 @@
+/* Copyright 2020 Semantic Weights. All rights reserved. */
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "absl/flags/flag.h"
+#include "absl/flags/parse.h"
+#include "absl/strings/str_format.h"
+#include "src/double_dummy_tables.h"
+#include "src/game.h"
+#include "src/thread_pool.h"
+
+ABSL_FLAG(int, num_players, 3, "Number of players.");
+ABSL_FLAG(int, seed, 0, "Game seed from which the deals are derived.");
+ABSL_FLAG(int, first_deal, 0, "Index of the first deal.");
+ABSL_FLAG(int, num_deals, 1, "Number of consecutive deals.");
+ABSL_FLAG(int, deals_per_batch, 100,
+          "Number of deals solved before their tables are written.");
+ABSL_FLAG(int64_t, max_nodes, 10000000,
+          "Maximum number of positions per solve, 0 means no limit.");
+ABSL_FLAG(int, num_threads, std::thread::hardware_concurrency(),
+          "Number of threads that run the solves.");
+ABSL_FLAG(std::string, output, "double_dummy_tables.bin",
+          "Path of the file to which the tables are appended.");
+
+// computes double dummy tables of consecutive deals and appends them to the
+// output file in batches so that long runs can be resumed with --first_deal
+int main(int argc, char** argv) {
+  absl::ParseCommandLine(argc, argv);
+  auto game = tarok::NewTarokGame(open_spiel::GameParameters(
+      {{"num_players",
+        open_spiel::GameParameter(absl::GetFlag(FLAGS_num_players))},
+       {"seed", open_spiel::GameParameter(absl::GetFlag(FLAGS_seed))}}));
+  tarok::ThreadPool pool(std::max(absl::GetFlag(FLAGS_num_threads), 1));
+  std::ofstream out(absl::GetFlag(FLAGS_output),
+                    std::ios::binary | std::ios::app);
+  if (!out) {
+    std::cerr << "can't open " << absl::GetFlag(FLAGS_output) << std::endl;
+    return 1;
+  }
+
+  int64_t first_deal = absl::GetFlag(FLAGS_first_deal);
+  int64_t end_deal = first_deal + absl::GetFlag(FLAGS_num_deals);
+  int deals_per_batch = std::max(absl::GetFlag(FLAGS_deals_per_batch), 1);
+  int64_t num_entries = 0;
+  int64_t num_won_entries = 0;
+  int64_t num_solved_entries = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int64_t deal = first_deal; deal < end_deal; deal += deals_per_batch) {
+    int num_deals = std::min<int64_t>(deals_per_batch, end_deal - deal);
+    auto tables = tarok::DoubleDummyTables(
+        *game, deal, num_deals, absl::GetFlag(FLAGS_max_nodes), &pool);
+    for (auto const& table : tables) {
+      tarok::WriteDoubleDummyTable(table, &out);
+      for (auto const& entry : table.entries) {
+        num_entries++;
+        num_won_entries += entry.won != 0;
+        num_solved_entries += entry.lower == entry.upper;
+      }
+    }
+    out.flush();
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    std::cout << absl::StrFormat(
+                     "deals %d - %d done, won solved in %d / %d entries, "
+                     "returns solved in %d / %d entries, %.3fs",
+                     first_deal, deal + num_deals - 1, num_won_entries,
+                     num_entries, num_solved_entries, num_entries,
+                     elapsed.count())
+              << std::endl;
+  }
+  return 0;
+}
@@ -0,0 +1,35 @@
+/* Copyright 2020 Semantic Weights. All rights reserved. */
+
+#include <memory>
+
+#include "benchmark/benchmark.h"
+#include "src/game.h"
+#include "src/ismcts.h"
+
+namespace tarok {
+
+// a single search of the first bid with the given number of players and
+// threads, reported items are iterations
+void BM_IsmctsStep(benchmark::State& bm_state) {
+  int num_players = bm_state.range(0);
+  auto game = NewTarokGame(open_spiel::GameParameters(
+      {{"num_players", open_spiel::GameParameter(num_players)},
+       {"seed", open_spiel::GameParameter(0)}}));
+  auto state = game->NewInitialTarokState();
+  state->ApplyAction(0);
+  IsmctsConfig config;
+  config.num_iterations = 10000;
+  config.num_threads = bm_state.range(1);
+  config.reuse_tree = false;
+  IsmctsBot bot(config);
+  for (auto _ : bm_state) benchmark::DoNotOptimize(bot.Step(*state));
+  bm_state.SetItemsProcessed(bm_state.iterations() * 10000);
+}
+
+BENCHMARK(BM_IsmctsStep)
+    ->Args({3, 1})
+    ->Args({4, 1})
+    ->Args({3, 4})
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace tarok
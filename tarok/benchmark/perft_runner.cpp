@@ -0,0 +1,64 @@
+/* Copyright 2020 Semantic Weights. All rights reserved. */
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+#include "absl/flags/flag.h"
+#include "absl/flags/parse.h"
+#include "absl/strings/str_format.h"
+#include "src/game.h"
+#include "src/perft.h"
+
+ABSL_FLAG(int, num_players, 3, "Number of players.");
+ABSL_FLAG(int, seed, 0, "Game seed from which the deals are derived.");
+ABSL_FLAG(int, first_deal, 0, "Index of the first deal.");
+ABSL_FLAG(int, num_deals, 1, "Number of consecutive deals.");
+ABSL_FLAG(int, depth, 8, "Maximum depth relative to the dealt states.");
+ABSL_FLAG(bool, until_tricks_playing, false,
+          "Don't expand nodes in the tricks playing phase.");
+ABSL_FLAG(int, num_threads, std::thread::hardware_concurrency(),
+          "Number of threads among which the deals are distributed.");
+
+// counts nodes per depth and game phase for fixed deals, e.g. the whole
+// bidding, king calling and talon exchange tree of a deal can be enumerated
+// with --until_tricks_playing --depth=30
+int main(int argc, char** argv) {
+  absl::ParseCommandLine(argc, argv);
+  auto game = tarok::NewTarokGame(open_spiel::GameParameters(
+      {{"num_players",
+        open_spiel::GameParameter(absl::GetFlag(FLAGS_num_players))},
+       {"seed", open_spiel::GameParameter(absl::GetFlag(FLAGS_seed))}}));
+  tarok::GamePhase last_game_phase = absl::GetFlag(FLAGS_until_tricks_playing)
+                                         ? tarok::GamePhase::kTalonExchange
+                                         : tarok::GamePhase::kFinished;
+
+  auto start = std::chrono::steady_clock::now();
+  auto counts = tarok::ParallelPerft(
+      *game, absl::GetFlag(FLAGS_first_deal), absl::GetFlag(FLAGS_num_deals),
+      absl::GetFlag(FLAGS_depth), last_game_phase,
+      std::max(absl::GetFlag(FLAGS_num_threads), 1));
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+
+  std::cout << absl::StrFormat("%5s %14s", "depth", "nodes");
+  for (int phase = 0; phase < 6; phase++) {
+    std::cout << absl::StrFormat(
+        " %14s",
+        tarok::GamePhaseToString(static_cast<tarok::GamePhase>(phase)));
+  }
+  std::cout << std::endl;
+  for (size_t depth = 0; depth < counts.nodes.size(); depth++) {
+    std::cout << absl::StrFormat("%5d %14d", depth, counts.Nodes(depth));
+    for (auto const& phase_nodes : counts.nodes.at(depth)) {
+      std::cout << absl::StrFormat(" %14d", phase_nodes);
+    }
+    std::cout << std::endl;
+  }
+  std::cout << absl::StrFormat("total nodes: %d, %.3fs, %.0f nodes/s",
+                               counts.TotalNodes(), elapsed.count(),
+                               counts.TotalNodes() / elapsed.count())
+            << std::endl;
+  return 0;
+}
@@ -0,0 +1,26 @@
+/* Copyright 2020 Semantic Weights. All rights reserved. */
+
+#include "benchmark/benchmark.h"
+#include "src/random_games.h"
+
+namespace tarok {
+
+// 1024 random games with the given number of players and threads, reported
+// items are games
+void BM_PlayRandomGames(benchmark::State& bm_state) {
+  int num_players = bm_state.range(0);
+  int num_threads = bm_state.range(1);
+  for (auto _ : bm_state) {
+    benchmark::DoNotOptimize(
+        PlayRandomGames(1024, 0, num_threads, num_players));
+  }
+  bm_state.SetItemsProcessed(bm_state.iterations() * 1024);
+}
+
+BENCHMARK(BM_PlayRandomGames)
+    ->Args({3, 1})
+    ->Args({4, 1})
+    ->Args({3, 4})
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace tarok
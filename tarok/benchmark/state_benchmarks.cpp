@@ -0,0 +1,275 @@
+/* Copyright 2020 Semantic Weights. All rights reserved. */
+
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "src/game.h"
+
+namespace tarok {
+
+std::shared_ptr<const TarokGame> NewBenchmarkGame(int num_players) {
+  return NewTarokGame(open_spiel::GameParameters(
+      {{"num_players", open_spiel::GameParameter(num_players)},
+       {"seed", open_spiel::GameParameter(0)}}));
+}
+
+// deals the cards and lets the forehand bid the given contract while all the
+// other players pass
+std::unique_ptr<TarokState> NewStateWithContract(const TarokGame& game,
+                                                 ContractName contract) {
+  auto state = game.NewInitialTarokState();
+  state->ApplyTrustedAction(0);
+  while (state->CurrentPlayer() != 0) state->ApplyTrustedAction(kBidPassAction);
+  // bidding actions are offset by one since action 0 means pass
+  state->ApplyTrustedAction(static_cast<int>(contract) + 1);
+  return state;
+}
+
+void PlayRandomActions(TarokState* state, std::mt19937* rng) {
+  while (!state->IsTerminal()) {
+    state->ApplyTrustedAction(RandomAction(state->LegalActionsBitmask(), rng));
+  }
+}
+
+// collects distinct states of the given game phase reached by random play
+std::vector<std::unique_ptr<TarokState>> RandomStatesInGamePhase(
+    const TarokGame& game, GamePhase game_phase, std::mt19937* rng) {
+  std::vector<std::unique_ptr<TarokState>> states;
+  while (states.size() < 64) {
+    auto state = game.NewInitialTarokState();
+    while (!state->IsTerminal() && state->CurrentGamePhase() <= game_phase) {
+      if (state->CurrentGamePhase() == game_phase) {
+        states.emplace_back(static_cast<TarokState*>(state->Clone().release()));
+      }
+      state->ApplyTrustedAction(
+          RandomAction(state->LegalActionsBitmask(), rng));
+    }
+  }
+  return states;
+}
+
+// registers all contracts that can be played by the given number of players
+void AllContractsArgs(benchmark::internal::Benchmark* benchmark) {
+  for (int num_players : {3, 4}) {
+    for (int contract = static_cast<int>(ContractName::kKlop);
+         contract < static_cast<int>(ContractName::kNotSelected); contract++) {
+      if (num_players == 3 && contract >= kBidSoloThreeAction - 1 &&
+          contract <= kBidSoloOneAction - 1) {
+        continue;
+      }
+      benchmark->Args({num_players, contract});
+    }
+  }
+}
+
+// plays random games and reports the number of applied actions (including the
+// dealing chance action) per second
+template <bool trusted>
+void PlayRandomGames(benchmark::State& bm_state) {
+  auto game = NewBenchmarkGame(bm_state.range(0));
+  std::mt19937 rng(0);
+  int64_t num_steps = 0;
+
+  for (auto _ : bm_state) {
+    auto state = game->NewInitialTarokState();
+    while (!state->IsTerminal()) {
+      open_spiel::Action action =
+          RandomAction(state->LegalActionsBitmask(), &rng);
+      if (trusted)
+        state->ApplyTrustedAction(action);
+      else
+        state->ApplyAction(action);
+      num_steps++;
+    }
+  }
+  bm_state.SetItemsProcessed(num_steps);
+}
+
+void BM_ApplyAction(benchmark::State& bm_state) {
+  PlayRandomGames<false>(bm_state);
+}
+BENCHMARK(BM_ApplyAction)->Arg(3)->Arg(4);
+
+void BM_ApplyTrustedAction(benchmark::State& bm_state) {
+  PlayRandomGames<true>(bm_state);
+}
+BENCHMARK(BM_ApplyTrustedAction)->Arg(3)->Arg(4);
+
+// plays random games where the forehand always bids the same contract and
+// reports the number of games per second
+void BM_RandomGamesPerContract(benchmark::State& bm_state) {
+  auto game = NewBenchmarkGame(bm_state.range(0));
+  auto contract = static_cast<ContractName>(bm_state.range(1));
+  std::mt19937 rng(0);
+  for (auto _ : bm_state) {
+    auto state = NewStateWithContract(*game, contract);
+    PlayRandomActions(state.get(), &rng);
+  }
+  bm_state.SetItemsProcessed(bm_state.iterations());
+  bm_state.SetLabel(ContractNameToString(contract));
+}
+BENCHMARK(BM_RandomGamesPerContract)->Apply(AllContractsArgs);
+
+// plays random actions until the end of the game and undoes them again,
+// starting from states in the tricks playing phase, i.e. the legal actions,
+// apply and undo paths taken by rollouts and search, reports the number of
+// applied actions per second
+void BM_RandomRolloutsWithUndo(benchmark::State& bm_state) {
+  auto game = NewBenchmarkGame(bm_state.range(0));
+  std::mt19937 rng(0);
+  auto states =
+      RandomStatesInGamePhase(*game, GamePhase::kTricksPlaying, &rng);
+  int64_t num_steps = 0;
+  int i = 0;
+  for (auto _ : bm_state) {
+    TarokState& state = *states[i++ % states.size()];
+    int num_applied = 0;
+    while (!state.IsTerminal()) {
+      state.ApplyTrustedAction(RandomAction(state.LegalActionsBitmask(), &rng));
+      num_applied++;
+    }
+    num_steps += num_applied;
+    for (; num_applied > 0; num_applied--) {
+      const auto& last_action = state.FullHistory().back();
+      state.UndoAction(last_action.player, last_action.action);
+    }
+  }
+  bm_state.SetItemsProcessed(num_steps);
+}
+BENCHMARK(BM_RandomRolloutsWithUndo)->Arg(3)->Arg(4);
+
+// creates new states and deals the cards
+void BM_ApplyDealCardsAction(benchmark::State& bm_state) {
+  auto game = NewBenchmarkGame(bm_state.range(0));
+  for (auto _ : bm_state) {
+    auto state = game->NewInitialTarokState();
+    state->ApplyTrustedAction(0);
+    benchmark::DoNotOptimize(state);
+  }
+  bm_state.SetItemsProcessed(bm_state.iterations());
+}
+BENCHMARK(BM_ApplyDealCardsAction)->Arg(3)->Arg(4);
+
+template <bool bitmask>
+void LegalActionsInGamePhase(benchmark::State& bm_state) {
+  auto game = NewBenchmarkGame(bm_state.range(0));
+  auto game_phase = static_cast<GamePhase>(bm_state.range(1));
+  std::mt19937 rng(0);
+  auto states = RandomStatesInGamePhase(*game, game_phase, &rng);
+  int i = 0;
+  for (auto _ : bm_state) {
+    const TarokState& state = *states[i++ % states.size()];
+    if (bitmask)
+      benchmark::DoNotOptimize(state.LegalActionsBitmask());
+    else
+      benchmark::DoNotOptimize(state.LegalActions());
+  }
+  bm_state.SetItemsProcessed(bm_state.iterations());
+  bm_state.SetLabel(GamePhaseToString(game_phase));
+}
+
+// registers all game phases in which players choose actions, the king calling
+// phase is only reachable with four players
+void PlayerGamePhasesArgs(benchmark::internal::Benchmark* benchmark) {
+  for (int num_players : {3, 4}) {
+    for (auto game_phase : {GamePhase::kBidding, GamePhase::kKingCalling,
+                            GamePhase::kTalonExchange,
+                            GamePhase::kTricksPlaying}) {
+      if (num_players == 3 && game_phase == GamePhase::kKingCalling) continue;
+      benchmark->Args({num_players, static_cast<int>(game_phase)});
+    }
+  }
+}
+
+void BM_LegalActions(benchmark::State& bm_state) {
+  LegalActionsInGamePhase<false>(bm_state);
+}
+BENCHMARK(BM_LegalActions)->Apply(PlayerGamePhasesArgs);
+
+void BM_LegalActionsBitmask(benchmark::State& bm_state) {
+  LegalActionsInGamePhase<true>(bm_state);
+}
+BENCHMARK(BM_LegalActionsBitmask)->Apply(PlayerGamePhasesArgs);
+
+// scores finished games of the given contract
+void BM_Returns(benchmark::State& bm_state) {
+  auto game = NewBenchmarkGame(bm_state.range(0));
+  auto contract = static_cast<ContractName>(bm_state.range(1));
+  std::mt19937 rng(0);
+  std::vector<std::unique_ptr<TarokState>> states;
+  for (int i = 0; i < 64; i++) {
+    states.push_back(NewStateWithContract(*game, contract));
+    PlayRandomActions(states.back().get(), &rng);
+  }
+  int i = 0;
+  for (auto _ : bm_state) {
+    benchmark::DoNotOptimize(states[i++ % states.size()]->Returns());
+  }
+  bm_state.SetItemsProcessed(bm_state.iterations());
+  bm_state.SetLabel(ContractNameToString(contract));
+}
+BENCHMARK(BM_Returns)->Apply(AllContractsArgs);
+
+// renders info states of the current player in the tricks playing phase
+void BM_InformationStateString(benchmark::State& bm_state) {
+  auto game = NewBenchmarkGame(bm_state.range(0));
+  std::mt19937 rng(0);
+  auto states =
+      RandomStatesInGamePhase(*game, GamePhase::kTricksPlaying, &rng);
+  int i = 0;
+  for (auto _ : bm_state) {
+    const TarokState& state = *states[i++ % states.size()];
+    benchmark::DoNotOptimize(
+        state.InformationStateString(state.CurrentPlayer()));
+  }
+  bm_state.SetItemsProcessed(bm_state.iterations());
+}
+BENCHMARK(BM_InformationStateString)->Arg(3)->Arg(4);
+
+// renders info states of all players in finished games, i.e. with the longest
+// histories
+void BM_InformationStateStringInFinishedGames(benchmark::State& bm_state) {
+  auto game = NewBenchmarkGame(bm_state.range(0));
+  std::mt19937 rng(0);
+  std::vector<std::unique_ptr<TarokState>> states;
+  for (int i = 0; i < 64; i++) {
+    states.push_back(game->NewInitialTarokState());
+    PlayRandomActions(states.back().get(), &rng);
+  }
+  int i = 0;
+  for (auto _ : bm_state) {
+    const TarokState& state = *states[i / game->NumPlayers() % states.size()];
+    benchmark::DoNotOptimize(
+        state.InformationStateString(i++ % game->NumPlayers()));
+  }
+  bm_state.SetItemsProcessed(bm_state.iterations());
+}
+BENCHMARK(BM_InformationStateStringInFinishedGames)->Arg(3)->Arg(4);
+
+// clones a state in the middle of the tricks playing phase, as done at every
+// node by search algorithms
+void BM_Clone(benchmark::State& bm_state) {
+  auto game = NewBenchmarkGame(bm_state.range(0));
+  std::mt19937 rng(0);
+  std::unique_ptr<TarokState> state;
+  do {
+    state = game->NewInitialTarokState();
+    while (!state->IsTerminal() &&
+           (state->CurrentGamePhase() != GamePhase::kTricksPlaying ||
+            state->PlayerCards(0).size() > 8)) {
+      state->ApplyTrustedAction(
+          RandomAction(state->LegalActionsBitmask(), &rng));
+    }
+  } while (state->IsTerminal());
+
+  for (auto _ : bm_state) {
+    auto clone = state->Clone();
+    benchmark::DoNotOptimize(clone);
+  }
+  bm_state.SetItemsProcessed(bm_state.iterations());
+}
+BENCHMARK(BM_Clone)->Arg(3)->Arg(4);
+
+}  // namespace tarok
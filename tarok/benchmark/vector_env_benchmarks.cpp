@@ -0,0 +1,39 @@
+/* Copyright 2020 Semantic Weights. All rights reserved. */
+
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "src/game.h"
+#include "src/vector_env.h"
+
+namespace tarok {
+
+// steps of 256 games with random legal actions, reported items are actions
+void BM_VectorEnvStep(benchmark::State& bm_state) {
+  int num_players = bm_state.range(0);
+  auto game = NewTarokGame(open_spiel::GameParameters(
+      {{"num_players", open_spiel::GameParameter(num_players)},
+       {"seed", open_spiel::GameParameter(0)}}));
+  constexpr int kNumEnvs = 256;
+  TarokVectorEnv env(game, kNumEnvs);
+  std::mt19937 rng(0);
+  std::vector<open_spiel::Action> actions(kNumEnvs);
+  for (auto _ : bm_state) {
+    bm_state.PauseTiming();
+    for (int i = 0; i < kNumEnvs; i++) {
+      ActionBitmask legal_actions = env.State(i).LegalActionsBitmask();
+      for (int j = rng() % __builtin_popcountll(legal_actions); j > 0; j--)
+        legal_actions &= legal_actions - 1;
+      actions[i] = __builtin_ctzll(legal_actions);
+    }
+    bm_state.ResumeTiming();
+    env.Step(actions);
+  }
+  bm_state.SetItemsProcessed(bm_state.iterations() * kNumEnvs);
+}
+
+BENCHMARK(BM_VectorEnvStep)->Arg(3)->Arg(4);
+
+}  // namespace tarok
@@ -25,7 +25,7 @@ if [ ! -d ${BUILD_DIR} ]; then
 fi
 cd ${BUILD_DIR}
 cmake ../tarok
-make pytarok tarok_tests pyspiel
+make pytarok tarok_tests tarok_benchmarks pyspiel
 
 # remind to add modules to python path
 cd ..
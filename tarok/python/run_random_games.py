@@ -1,19 +1,20 @@
 import time
 
 import numpy as np
-import pyspiel as sp
 import pytarok as ta
 
 
 if __name__ == '__main__':
-    game = ta.TarokGame({})
     start_time = time.time()
+    # games are played natively on multiple threads, see
+    # src/random_games.h for details
+    results = ta.play_random_games(num_games=10000, seed=0, num_threads=4)
 
-    for i in range(10000):
-        state = game.new_initial_state()
-        while not state.is_terminal():
-            state.apply_action(np.random.choice(state.legal_actions()))
-        print("Game {:d}, {}, rewards: {}".format(
-            i + 1, state.selected_contract(), state.rewards()))
+    for contract in np.unique(results["contracts"]):
+        games = results["contracts"] == contract
+        print("{}, games: {:d}, mean returns: {}".format(
+            ta.Contract(int(contract)), np.count_nonzero(games),
+            results["returns"][games].mean(axis=0)))
+    print("Mean game length: {:.2f}".format(results["game_lengths"].mean()))
 
     print("Simulation ran for {:.2f} seconds".format(time.time() - start_time))
@@ -3,6 +3,7 @@
 #include "src/cards.h"
 
 #include <algorithm>
+#include <numeric>
 #include <random>
 #include <utility>
 
@@ -80,53 +81,87 @@ const std::array<Card, 54> InitializeCardDeck() {
           Card(CardSuit::kClubs, 7, 5, "CKI", "King of Clubs")};
 }
 
-DealtCards DealCards(int num_players, int seed) {
-  std::vector<open_spiel::Action> cards(54);
-  std::iota(cards.begin(), cards.end(), 0);
-  Shuffle(&cards, std::mt19937(seed));
-
-  // first six cards are talon
-  auto begin = cards.begin();
-  auto end = begin + 6;
-  std::vector<open_spiel::Action> talon(begin, end);
+const std::array<Card, 54>& CardDeck() {
+  static const std::array<Card, 54> card_deck = InitializeCardDeck();
+  return card_deck;
+}
 
-  // deal the rest of the cards to players
-  int num_cards_per_player = 48 / num_players;
+DealtCards DealCards(int num_players, int seed) {
+  auto dealt = DealCardSets(num_players, seed);
+  std::vector<open_spiel::Action> talon(dealt.talon.begin(), dealt.talon.end());
+  // player's cards are sorted since legal actions need to be returned in
+  // ascending order, card sets take care of that
   std::vector<std::vector<open_spiel::Action>> players_cards;
   players_cards.reserve(num_players);
-
-  std::advance(begin, 6);
   for (int i = 0; i < num_players; i++) {
-    std::advance(end, num_cards_per_player);
-    std::vector<open_spiel::Action> player_cards(begin, end);
-    // player's cards are sorted since legal actions need to be returned in
-    // ascending order
-    std::sort(player_cards.begin(), player_cards.end());
-    players_cards.push_back(player_cards);
-    std::advance(begin, num_cards_per_player);
+    players_cards.push_back(CardSetToActions(dealt.players_cards.at(i)));
   }
-
   return {talon, players_cards};
 }
 
+DealtCardSets DealCardSets(int num_players, int seed) {
+  std::array<int8_t, 54> cards;
+  std::iota(cards.begin(), cards.end(), 0);
+  // the same algorithm as in Shuffle() so that deals don't change
+  std::mt19937 rng(seed);
+  for (int i = cards.size() - 1; i > 0; i--) {
+    std::swap(cards[i], cards[rng() % (i + 1)]);
+  }
+
+  // first six cards are talon, the rest is dealt to players
+  DealtCardSets dealt;
+  std::copy_n(cards.begin(), 6, dealt.talon.begin());
+  int num_cards_per_player = 48 / num_players;
+  for (int i = 0; i < num_players; i++) {
+    for (int j = 6 + i * num_cards_per_player;
+         j < 6 + (i + 1) * num_cards_per_player; j++) {
+      dealt.players_cards[i] |= CardActionToCardSet(cards[j]);
+    }
+  }
+  return dealt;
+}
+
 void Shuffle(std::vector<open_spiel::Action>* actions, std::mt19937&& rng) {
   for (int i = actions->size() - 1; i > 0; i--) {
     std::swap(actions->at(i), actions->at(rng() % (i + 1)));
   }
 }
 
-int CardPoints(const std::vector<open_spiel::Action>& actions,
-               const std::array<Card, 54>& deck) {
+std::vector<open_spiel::Action> CardSetToActions(CardSet cards) {
+  std::vector<open_spiel::Action> actions;
+  actions.reserve(CardSetSize(cards));
+  while (cards != kEmptyCardSet) {
+    actions.push_back(LowestCardAction(cards));
+    // clear the lowest set bit
+    cards &= cards - 1;
+  }
+  return actions;
+}
+
+CardSet ActionsToCardSet(const std::vector<open_spiel::Action>& actions) {
+  CardSet cards = kEmptyCardSet;
+  for (auto const& action : actions) {
+    cards |= CardActionToCardSet(action);
+  }
+  return cards;
+}
+
+int CardPoints(const std::vector<open_spiel::Action>& actions) {
   // counting is done in batches of three (for every batch we sum up points from
   // three cards and subtract 2 points, if the last batch has less than three
   // cards we subtract 1 point), mathematically, this is equevalent to
   // subtracting 2/3 from each card
-  float points = 0;
-  for (auto const& action : actions) {
-    points += deck.at(action).points;
-  }
-  points -= actions.size() * 0.666f;
-  return static_cast<int>(round(points));
+  return CardPoints(ActionsToCardSet(actions));
+}
+
+int CardPoints(CardSet cards) {
+  // see the comment above for the counting rules, cards are summed up per
+  // points value instead of one by one and the result is rounded in integer
+  // arithmetic, i.e. thirds of points are rounded down and two thirds up
+  int points = 0;
+  for (size_t i = 0; i < kCardTable.points_card_sets.size(); i++)
+    points += (i + 1) * CardSetSize(cards & kCardTable.points_card_sets[i]);
+  return (3 * points - 2 * CardSetSize(cards) + 1) / 3;
 }
 
 }  // namespace tarok
@@ -2,7 +2,9 @@
 
 #pragma once
 
+#include <algorithm>
 #include <array>
+#include <cstdint>
 #include <string>
 #include <tuple>
 #include <vector>
@@ -21,8 +23,10 @@ static constexpr int kKingOfDiamondsAction = 37;
 static constexpr int kKingOfSpadesAction = 45;
 static constexpr int kKingOfClubsAction = 53;
 
-enum class CardSuit { kHearts, kDiamonds, kSpades, kClubs, kTaroks };
+enum class CardSuit : int8_t { kHearts, kDiamonds, kSpades, kClubs, kTaroks };
 
+// a card with its names, used for rendering cards and in tests, rules of the
+// game only need the packed properties of CardTable
 struct Card {
   Card(CardSuit suit, int rank, int points, std::string short_name,
        std::string long_name);
@@ -37,17 +41,165 @@ struct Card {
 };
 
 const std::array<Card, 54> InitializeCardDeck();
+// the same cards as InitializeCardDeck() but built only once, on first use
+const std::array<Card, 54>& CardDeck();
+
+// a set of cards encoded as a bitmask where the i-th bit corresponds to the
+// card action i, i.e. to the card at index i within the card deck, note that
+// this relies on the ordering of cards returned by InitializeCardDeck()
+using CardSet = uint64_t;
+
+static constexpr CardSet kEmptyCardSet = 0;
+static constexpr CardSet kFullCardSet = (CardSet{1} << 54) - 1;
+
+constexpr CardSet CardActionToCardSet(open_spiel::Action action) {
+  return CardSet{1} << action;
+}
+
+constexpr bool CardActionInCardSet(open_spiel::Action action, CardSet cards) {
+  return (cards & CardActionToCardSet(action)) != kEmptyCardSet;
+}
+
+constexpr CardSet SuitToCardSet(CardSuit suit) {
+  switch (suit) {
+    case CardSuit::kTaroks:
+      return (CardSet{1} << 22) - 1;
+    case CardSuit::kHearts:
+      return CardSet{0xFF} << 22;
+    case CardSuit::kDiamonds:
+      return CardSet{0xFF} << 30;
+    case CardSuit::kSpades:
+      return CardSet{0xFF} << 38;
+    case CardSuit::kClubs:
+      return CardSet{0xFF} << 46;
+  }
+  return kEmptyCardSet;
+}
+
+inline int CardSetSize(CardSet cards) { return __builtin_popcountll(cards); }
+
+// returns the lowest card action in a non-empty set
+inline open_spiel::Action LowestCardAction(CardSet cards) {
+  return __builtin_ctzll(cards);
+}
+
+// suit, rank and points of each card packed into bytes indexed by card
+// actions, all of it fits into three cache lines and is a compile time
+// constant, ranks and points are the same as those of InitializeCardDeck()
+struct CardTable {
+  std::array<CardSuit, 54> suits;
+  std::array<int8_t, 54> ranks;
+  std::array<int8_t, 54> points;
+  // the i-th set holds all cards worth i + 1 points
+  std::array<CardSet, 5> points_card_sets;
+};
+
+constexpr CardTable InitializeCardTable() {
+  CardTable table{};
+  for (int action = 0; action < 54; action++) {
+    if (action < 22) {
+      // pagat, mond and skis are worth 5 points, the other taroks 1 point
+      table.suits[action] = CardSuit::kTaroks;
+      table.ranks[action] = 8 + action;
+      table.points[action] = action == kPagatAction || action >= kMondAction
+                                 ? 5
+                                 : 1;
+    } else {
+      // the lowest four cards of a suit are worth 1 point, then jack, knight,
+      // queen and king are worth 2 to 5 points
+      int rank = (action - 22) % 8;
+      table.suits[action] = static_cast<CardSuit>((action - 22) / 8);
+      table.ranks[action] = rank;
+      table.points[action] = rank < 4 ? 1 : rank - 2;
+    }
+    table.points_card_sets[table.points[action] - 1] |=
+        CardActionToCardSet(action);
+  }
+  return table;
+}
+
+static constexpr CardTable kCardTable = InitializeCardTable();
+
+constexpr CardSuit CardActionSuit(open_spiel::Action action) {
+  return kCardTable.suits[action];
+}
+
+constexpr int CardActionRank(open_spiel::Action action) {
+  return kCardTable.ranks[action];
+}
+
+constexpr int CardActionPoints(open_spiel::Action action) {
+  return kCardTable.points[action];
+}
+
+static constexpr CardSet kKingsCardSet =
+    CardActionToCardSet(kKingOfHeartsAction) |
+    CardActionToCardSet(kKingOfDiamondsAction) |
+    CardActionToCardSet(kKingOfSpadesAction) |
+    CardActionToCardSet(kKingOfClubsAction);
+static constexpr CardSet kTrulaCardSet = CardActionToCardSet(kPagatAction) |
+                                         CardActionToCardSet(kMondAction) |
+                                         CardActionToCardSet(kSkisAction);
+
+// a fixed capacity sequence of card actions kept in the order in which they
+// were added, unlike std::vector it is trivially copyable and small enough to
+// be part of the packed state, used for card collections whose order carries
+// meaning such as talon and trick cards
+template <int kCapacity>
+class CardActions {
+ public:
+  bool operator==(const CardActions& other) const {
+    return std::equal(begin(), end(), other.begin(), other.end());
+  }
+
+  int size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+  open_spiel::Action at(int index) const { return actions_.at(index); }
+  open_spiel::Action front() const { return at(0); }
+  const int8_t* begin() const { return actions_.data(); }
+  const int8_t* end() const { return actions_.data() + size_; }
+
+  void push_back(open_spiel::Action action) { actions_.at(size_++) = action; }
+  void pop_back() { size_--; }
+  void clear() { size_ = 0; }
+
+  CardSet ToCardSet() const {
+    CardSet cards = kEmptyCardSet;
+    for (auto const& action : *this) cards |= CardActionToCardSet(action);
+    return cards;
+  }
+  std::vector<open_spiel::Action> ToVector() const {
+    return std::vector<open_spiel::Action>(begin(), end());
+  }
+
+ private:
+  std::array<int8_t, kCapacity> actions_{};
+  int8_t size_ = 0;
+};
+
+// card actions are returned in ascending order
+std::vector<open_spiel::Action> CardSetToActions(CardSet cards);
+CardSet ActionsToCardSet(const std::vector<open_spiel::Action>& actions);
 
 // a type for a pair holding talon and players' private cards
 using DealtCards = std::tuple<std::vector<open_spiel::Action>,
                               std::vector<std::vector<open_spiel::Action>>>;
 DealtCards DealCards(int num_players, int seed);
 
+// same deal as DealCards() but shuffled in place into a fixed size array and
+// returned as card sets, i.e. without any heap allocations or sorting, talon
+// cards are kept in the order in which they were dealt
+struct DealtCardSets {
+  std::array<int8_t, 6> talon{};
+  std::array<CardSet, 4> players_cards{};
+};
+DealtCardSets DealCardSets(int num_players, int seed);
+
 // we use our own implementation since std::shuffle is non-deterministic across
 // different versions of the standard library implementation
 void Shuffle(std::vector<open_spiel::Action>* actions, std::mt19937&& rng);
 
-int CardPoints(const std::vector<open_spiel::Action>& actions,
-               const std::array<Card, 54>& deck);
+int CardPoints(const std::vector<open_spiel::Action>& actions);
+int CardPoints(CardSet cards);
 
 }  // namespace tarok
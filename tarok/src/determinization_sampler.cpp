@@ -0,0 +1,282 @@
+/* Copyright 2020 Semantic Weights. All rights reserved. */
+
+#include "src/determinization_sampler.h"
+
+#include <utility>
+
+namespace tarok {
+
+static constexpr CardSet kTaroksCardSet = SuitToCardSet(CardSuit::kTaroks);
+
+DeterminizationSampler::DeterminizationSampler(const TarokState& state,
+                                               open_spiel::Player player)
+    : state_(static_cast<TarokState*>(state.Clone().release())),
+      player_(player),
+      num_players_(state.NumPlayers()) {
+  SPIEL_CHECK_GE(player, 0);
+  SPIEL_CHECK_LT(player, num_players_);
+  SPIEL_CHECK_NE(state.CurrentGamePhase(), GamePhase::kCardDealing);
+
+  for (int i = 0; i < num_players_; i++)
+    excluded_cards_.at(i) = state.PubliclyExcludedCards(i);
+  FindHiddenCards(state);
+  InitializeSlacks();
+}
+
+void DeterminizationSampler::FindHiddenCards(const TarokState& state) {
+  open_spiel::Player declarer = state.Declarer();
+  CardSet played_cards = kEmptyCardSet;
+  for (int i = 0; i < num_players_; i++)
+    played_cards |= state.PlayedCardSet(i);
+  auto [selected_talon_set, discarded_cards] =
+      state.SelectedTalonSetAndDiscardedCards();
+  bool player_is_declarer = player_ == declarer;
+  known_discarded_cards_ =
+      player_is_declarer ? discarded_cards : discarded_cards & kTaroksCardSet;
+
+  // the talon is shown to all players in contracts with talon exchange while
+  // in klop, talon cards are shown one by one as they are gifted
+  GamePhase phase = state.CurrentGamePhase();
+  bool talon_shown = phase == GamePhase::kTalonExchange ||
+                     (phase > GamePhase::kTalonExchange &&
+                      state.SelectedContract().NeedsTalonExchange());
+  CardSet hidden_talon_cards =
+      talon_shown ? kEmptyCardSet : state.TalonCardSet();
+
+  known_players_cards_.at(player_) = state.PlayerCardSet(player_);
+  // taroks and kings of the selected talon set are either played or still held
+  // by the declarer since they can't be discarded without being shown
+  if (!player_is_declarer && selected_talon_set != kEmptyCardSet) {
+    known_players_cards_.at(declarer) =
+        selected_talon_set & (kTaroksCardSet | kKingsCardSet) &
+        ~played_cards & ~discarded_cards;
+  }
+
+  CardSet known_cards =
+      played_cards | known_discarded_cards_ |
+      (state.DealtTalonCardSet() & ~selected_talon_set & ~hidden_talon_cards);
+  for (auto const& cards : known_players_cards_) known_cards |= cards;
+  hidden_cards_ = kFullCardSet & ~known_cards;
+  // the rest of the selected talon set is either held or discarded by the
+  // declarer
+  CardSet talon_set_cards = selected_talon_set & hidden_cards_;
+
+  std::array<int, kNumLocations> capacities{};
+  for (int i = 0; i < num_players_; i++) {
+    if (i == player_) continue;
+    capacities.at(i) = CardSetSize(state.PlayerCardSet(i)) -
+                       CardSetSize(known_players_cards_.at(i));
+    // players don't know whether the other players' first dealt taroks are
+    // among the hidden cards unless one of them was shown already
+    CardSet shown_dealt_cards = state.PlayedCardSet(i);
+    if (i == declarer) shown_dealt_cards |= known_discarded_cards_;
+    needs_tarok_.at(i) =
+        (shown_dealt_cards & kTaroksCardSet & ~selected_talon_set) ==
+        kEmptyCardSet;
+  }
+  capacities.at(kTalonLocation) = CardSetSize(hidden_talon_cards);
+  capacities.at(kDiscardedLocation) =
+      CardSetSize(discarded_cards & ~known_discarded_cards_);
+
+  // only locations that need cards are tracked
+  locations_index_.fill(-1);
+  for (int i = 0; i < kNumLocations; i++) {
+    if (capacities.at(i) == 0) continue;
+    locations_index_.at(i) = num_locations_;
+    locations_.at(num_locations_) = i;
+    capacities_.at(num_locations_++) = capacities.at(i);
+  }
+  auto add_location = [this](int location, uint8_t* locations) {
+    if (locations_index_.at(location) >= 0)
+      *locations |= 1 << locations_index_.at(location);
+  };
+  all_locations_possible_ = true;
+  for (CardSet cards = hidden_cards_; cards != kEmptyCardSet;
+       cards &= cards - 1) {
+    open_spiel::Action action = LowestCardAction(cards);
+    CardSet card = CardActionToCardSet(action);
+    uint8_t locations = 0;
+    for (int i = 0; i < num_players_; i++) {
+      if (!(card & excluded_cards_.at(i)) &&
+          (!(card & talon_set_cards) || i == declarer)) {
+        add_location(i, &locations);
+      }
+    }
+    if (!(card & talon_set_cards)) add_location(kTalonLocation, &locations);
+    if (!(card & (kTaroksCardSet | kKingsCardSet)))
+      add_location(kDiscardedLocation, &locations);
+    SPIEL_CHECK_NE(locations, 0);
+    cards_locations_.at(action) = locations;
+    if (locations != (1 << num_locations_) - 1) all_locations_possible_ = false;
+  }
+}
+
+void DeterminizationSampler::InitializeSlacks() {
+  int num_location_sets = 1 << num_locations_;
+  for (int location_set = 0; location_set < num_location_sets; location_set++) {
+    for (int i = 0; i < num_locations_; i++) {
+      if (location_set & (1 << i)) {
+        containing_location_sets_.at(i) |= LocationSets{1} << location_set;
+        slacks_.at(location_set) += capacities_.at(i);
+      }
+    }
+    for (int superset = 0; superset < num_location_sets; superset++) {
+      if ((superset & location_set) == location_set) {
+        superset_location_sets_.at(location_set) |= LocationSets{1}
+                                                    << superset;
+      }
+    }
+  }
+  for (CardSet cards = hidden_cards_; cards != kEmptyCardSet;
+       cards &= cards - 1) {
+    uint8_t locations = cards_locations_.at(LowestCardAction(cards));
+    for (LocationSets sets = superset_location_sets_.at(locations); sets != 0;
+         sets &= sets - 1) {
+      slacks_.at(__builtin_ctzll(sets))--;
+    }
+  }
+  for (int location_set = 0; location_set < num_location_sets; location_set++) {
+    // the actual cards are one of the valid assignments
+    SPIEL_CHECK_GE(slacks_.at(location_set), 0);
+    if (slacks_.at(location_set) == 0)
+      tight_location_sets_ |= LocationSets{1} << location_set;
+  }
+}
+
+std::unique_ptr<TarokState> DeterminizationSampler::Sample(
+    std::mt19937* rng) const {
+  auto clone = state_->Clone();
+  auto* state = static_cast<TarokState*>(clone.get());
+  Resample(rng, state);
+  clone.release();
+  return std::unique_ptr<TarokState>(state);
+}
+
+void DeterminizationSampler::Resample(std::mt19937* rng,
+                                      TarokState* state) const {
+  SPIEL_CHECK_EQ(state->MoveNumber(), state_->MoveNumber());
+  std::array<int, kNumLocations> capacities;
+  std::array<int, kNumLocationSets> slacks;
+  LocationSets tight_location_sets;
+  std::array<CardSet, kNumLocations> locations_cards;
+  CardSet remaining_cards;
+
+  // a card can be put to a location as long as the slacks of location sets
+  // with the location that don't contain all of the card's locations stay
+  // non-negative
+  auto can_assign = [&](open_spiel::Action action, int location) {
+    return (tight_location_sets & containing_location_sets_[location] &
+            ~superset_location_sets_[cards_locations_[action]]) == 0;
+  };
+  auto assign = [&](open_spiel::Action action, int location) {
+    LocationSets containing = containing_location_sets_[location];
+    LocationSets supersets = superset_location_sets_[cards_locations_[action]];
+    for (LocationSets sets = containing & ~supersets; sets != 0;
+         sets &= sets - 1) {
+      int location_set = __builtin_ctzll(sets);
+      if (--slacks[location_set] == 0)
+        tight_location_sets |= LocationSets{1} << location_set;
+    }
+    for (LocationSets sets = supersets & ~containing; sets != 0;
+         sets &= sets - 1) {
+      int location_set = __builtin_ctzll(sets);
+      if (slacks[location_set]++ == 0)
+        tight_location_sets &= ~(LocationSets{1} << location_set);
+    }
+    capacities[location]--;
+    locations_cards[location] |= CardActionToCardSet(action);
+    remaining_cards &= ~CardActionToCardSet(action);
+  };
+
+  // players who haven't shown any dealt tarok yet must have been dealt one
+  // since deals without taroks are redealt, samples that contradict this are
+  // rejected the same way as such deals, unlike giving these players one of
+  // the hidden taroks up front this doesn't bias the samples
+  auto any_player_without_taroks = [&]() {
+    for (int i = 0; i < num_players_; i++) {
+      int location = locations_index_[i];
+      if (location >= 0 && needs_tarok_[i] &&
+          (locations_cards[location] & kTaroksCardSet) == kEmptyCardSet) {
+        return true;
+      }
+    }
+    return false;
+  };
+  do {
+    capacities = capacities_;
+    slacks = slacks_;
+    tight_location_sets = tight_location_sets_;
+    locations_cards = {};
+    remaining_cards = hidden_cards_;
+    if (all_locations_possible_) {
+      // all assignments are valid so the remaining cards are simply shuffled
+      // and split among the locations
+      std::array<int8_t, 54> actions;
+      int num_actions = 0;
+      for (CardSet cards = remaining_cards; cards != kEmptyCardSet;
+           cards &= cards - 1) {
+        actions[num_actions++] = LowestCardAction(cards);
+      }
+      for (int i = num_actions - 1; i > 0; i--)
+        std::swap(actions[i], actions[(*rng)() % (i + 1)]);
+      int action_index = 0;
+      for (int location = 0; location < num_locations_; location++) {
+        for (int i = 0; i < capacities[location]; i++) {
+          locations_cards[location] |=
+              CardActionToCardSet(actions[action_index++]);
+        }
+      }
+    } else {
+      for (CardSet cards = remaining_cards; cards != kEmptyCardSet;
+           cards &= cards - 1) {
+        open_spiel::Action action = LowestCardAction(cards);
+        std::array<int, kNumLocations> weights{};
+        int total_weight = 0;
+        for (int locations = cards_locations_[action]; locations != 0;
+             locations &= locations - 1) {
+          int location = __builtin_ctz(locations);
+          if (capacities[location] > 0 && can_assign(action, location)) {
+            weights[location] = capacities[location];
+            total_weight += capacities[location];
+          }
+        }
+        SPIEL_CHECK_GT(total_weight, 0);
+        int weight = (*rng)() % total_weight;
+        int location = 0;
+        while (weight >= weights[location]) weight -= weights[location++];
+        assign(action, location);
+      }
+    }
+  } while (any_player_without_taroks());
+
+  // cards of each location
+  std::array<CardSet, kNumLocations> cards{};
+  for (int i = 0; i < num_locations_; i++)
+    cards[locations_[i]] = locations_cards[i];
+  std::array<CardSet, 4> players_cards{};
+  for (int i = 0; i < num_players_; i++)
+    players_cards[i] = known_players_cards_[i] | cards[i];
+
+  // talon cards are put to the hidden positions in random order
+  std::array<int8_t, 6> talon_cards;
+  int num_talon_cards = 0;
+  for (CardSet talon = cards[kTalonLocation]; talon != kEmptyCardSet;
+       talon &= talon - 1) {
+    talon_cards[num_talon_cards++] = LowestCardAction(talon);
+  }
+  for (int i = num_talon_cards - 1; i > 0; i--)
+    std::swap(talon_cards[i], talon_cards[(*rng)() % (i + 1)]);
+  CardActions<6> talon;
+  for (int i = 0; i < num_talon_cards; i++) talon.push_back(talon_cards[i]);
+
+  state->ReplaceHiddenCards(players_cards, talon,
+                            known_discarded_cards_ | cards[kDiscardedLocation]);
+}
+
+CardSet DeterminizationSampler::HiddenCards() const { return hidden_cards_; }
+
+CardSet DeterminizationSampler::ExcludedCards(open_spiel::Player other) const {
+  return hidden_cards_ & excluded_cards_.at(other);
+}
+
+}  // namespace tarok
@@ -0,0 +1,102 @@
+/* Copyright 2020 Semantic Weights. All rights reserved. */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <random>
+
+#include "open_spiel/spiel.h"
+#include "src/cards.h"
+#include "src/state.h"
+
+namespace tarok {
+
+// samples states whose cards are consistent with everything the given player
+// has observed, i.e. the player's own cards, the talon once it's shown,
+// discarded taroks, all played cards and what the rules imply about other
+// players' cards when they play them (e.g. a player who didn't follow suit is
+// void in that suit, a player who didn't play a tarok either is also out of
+// taroks and in negative contracts a player who didn't beat the trick has no
+// higher card of the suit), all other cards (other players' cards, talon
+// cards that weren't shown and the declarer's discarded non-taroks) are
+// hidden and redistributed among their possible locations
+//
+// the constraints are taken from TarokState::PubliclyExcludedCards() once when
+// the sampler is created, afterwards each card is assigned to one of its
+// possible locations with probability proportional to the number of cards the
+// location still needs, locations that would leave the remaining cards
+// without a valid assignment are skipped, samples in which a player who hasn't
+// revealed any dealt tarok yet gets none of the hidden taroks are rejected
+// since deals without taroks are redealt, note that the samples are only
+// approximately uniform when there are constraints
+//
+// sampled states are full copies of the state with the hidden cards replaced
+// by TarokState::ReplaceHiddenCards() (including the hidden discarding actions
+// in history) so they can be played on, undone to the start of the game and
+// rendered into info states of any player
+class DeterminizationSampler {
+ public:
+  DeterminizationSampler(const TarokState& state, open_spiel::Player player);
+
+  std::unique_ptr<TarokState> Sample(std::mt19937* rng) const;
+  // replaces the hidden cards of a previously sampled state (or a clone of
+  // the sampled state) without any allocations, the state mustn't have been
+  // played on since
+  void Resample(std::mt19937* rng, TarokState* state) const;
+
+  // cards whose location is hidden from the player
+  CardSet HiddenCards() const;
+  // hidden cards that the other player can't hold according to the rules
+  CardSet ExcludedCards(open_spiel::Player other) const;
+
+ private:
+  // locations of hidden cards, the first four are players' hands
+  static constexpr int kTalonLocation = 4;
+  static constexpr int kDiscardedLocation = 5;
+  static constexpr int kNumLocations = 6;
+  // subsets of locations are encoded as bitmasks
+  static constexpr int kNumLocationSets = 1 << kNumLocations;
+  // sets of location sets are encoded as bitmasks as well
+  using LocationSets = uint64_t;
+
+  void FindHiddenCards(const TarokState& state);
+  void InitializeSlacks();
+
+  std::unique_ptr<TarokState> state_;
+  open_spiel::Player player_;
+  int num_players_;
+
+  // cards that are known to be held by each player
+  std::array<CardSet, 4> known_players_cards_{};
+  std::array<CardSet, 4> excluded_cards_{};
+  CardSet hidden_cards_ = kEmptyCardSet;
+  // only locations that need at least one card are used, these are indexed
+  // from 0 to num_locations_ - 1 in the order of locations
+  int num_locations_ = 0;
+  std::array<int, kNumLocations> locations_{};
+  // -1 for locations that aren't used
+  std::array<int, kNumLocations> locations_index_{};
+  std::array<int, kNumLocations> capacities_{};
+  // the set of used locations where each hidden card can be
+  std::array<uint8_t, 54> cards_locations_{};
+  // whether each hidden card can be in any of the used locations
+  bool all_locations_possible_ = true;
+  // players that weren't dealt any of the shown taroks
+  std::array<bool, 4> needs_tarok_{};
+  // discarded cards that the player saw
+  CardSet known_discarded_cards_ = kEmptyCardSet;
+
+  // for each location set, the capacity of its locations minus the number of
+  // cards that can only be put to its locations, all cards can be assigned
+  // as long as all slacks are non-negative
+  std::array<int, kNumLocationSets> slacks_{};
+  LocationSets tight_location_sets_ = 0;
+  // location sets that contain the i-th location
+  std::array<LocationSets, kNumLocations> containing_location_sets_{};
+  // location sets that are supersets of the i-th location set
+  std::array<LocationSets, kNumLocationSets> superset_location_sets_{};
+};
+
+}  // namespace tarok
@@ -0,0 +1,788 @@
+/* Copyright 2020 Semantic Weights. All rights reserved. */
+
+#include "src/double_dummy.h"
+
+#include <algorithm>
+#include <functional>
+#include <utility>
+
+#include "src/tricks.h"
+
+namespace tarok {
+
+// all returns lie well within these bounds
+static constexpr int kMinValue = -1000;
+static constexpr int kMaxValue = 1000;
+
+// indexed by ContractName, i.e. in the same order as TarokGame::contracts_
+static const std::array<Contract, 12> kContracts = InitializeContracts();
+
+// scores only depend on the sum of card points, the number of cards (see
+// CardPoints()) and on whether kings or trula were collected so each card
+// adds its points, one in the second byte and its bit among trula and kings
+// (in the order of card actions) above that to the summary of collected cards
+static constexpr int kSummaryCountShift = 8;
+static constexpr int kSummaryBonusShift = 16;
+static constexpr uint32_t kSummaryTrulaBits = 0x7 << kSummaryBonusShift;
+static constexpr uint32_t kSummaryKingsBits = 0x78 << kSummaryBonusShift;
+
+static constexpr std::array<uint32_t, 54> InitializeCardSummaries() {
+  std::array<uint32_t, 54> summaries{};
+  int bonus_bit = 0;
+  for (int action = 0; action < 54; action++) {
+    summaries[action] = kCardTable.points[action] | 1 << kSummaryCountShift;
+    if (CardActionInCardSet(action, kKingsCardSet | kTrulaCardSet))
+      summaries[action] |= 1 << (kSummaryBonusShift + bonus_bit++);
+  }
+  return summaries;
+}
+
+static constexpr std::array<uint32_t, 54> kCardSummaries =
+    InitializeCardSummaries();
+
+static uint32_t CollectedCardsSummary(CardSet cards) {
+  uint32_t summary = 0;
+  for (; cards != kEmptyCardSet; cards &= cards - 1)
+    summary += kCardSummaries[LowestCardAction(cards)];
+  return summary;
+}
+
+static int SummaryCardSetSize(uint32_t summary) {
+  return (summary >> kSummaryCountShift) & 0xFF;
+}
+
+// same as CardPoints() of the summarised cards
+static int SummaryCardPoints(uint32_t summary) {
+  return (3 * static_cast<int>(summary & 0xFF) -
+          2 * SummaryCardSetSize(summary) + 1) /
+         3;
+}
+
+// plain cards are the ones worth a single point, i.e. all taroks but trula and
+// the four lowest cards of each colour suit, they rank next to each other
+// within their suit and don't carry any bonuses
+static constexpr CardSet kPlainCardSet = kCardTable.points_card_sets[0];
+
+static CardSet SuitPlainCardSet(open_spiel::Action action) {
+  return kPlainCardSet & SuitToCardSet(CardActionSuit(action));
+}
+
+// the rest of the game only depends on the order of plain cards in play so
+// the i-th plain card of a suit in play is mapped to the i-th plain card of
+// the suit in positions
+static open_spiel::Action ToPositionAction(CardSet cards_in_play,
+                                           open_spiel::Action action) {
+  if (action == open_spiel::kInvalidAction ||
+      !CardActionInCardSet(action, kPlainCardSet)) {
+    return action;
+  }
+  CardSet suit_plain_cards = SuitPlainCardSet(action);
+  return LowestCardAction(suit_plain_cards) +
+         CardSetSize(cards_in_play & suit_plain_cards &
+                     (CardActionToCardSet(action) - 1));
+}
+
+static open_spiel::Action FromPositionAction(CardSet cards_in_play,
+                                             open_spiel::Action action) {
+  if (action == open_spiel::kInvalidAction ||
+      !CardActionInCardSet(action, kPlainCardSet)) {
+    return action;
+  }
+  CardSet suit_plain_cards = SuitPlainCardSet(action);
+  CardSet cards = cards_in_play & suit_plain_cards;
+  for (int i = LowestCardAction(suit_plain_cards); i < action; i++)
+    cards &= cards - 1;
+  return LowestCardAction(cards);
+}
+
+// the part of TarokState that changes while playing tricks, it is copied
+// rather than undone as it is small and trivially copyable
+struct DoubleDummySolver::SearchState {
+  std::array<CardSet, 4> players_cards;
+  // indexed by Side()
+  std::array<uint32_t, 4> collected_cards_summaries;
+  CardActions<4> trick_cards;
+  int8_t winning_trick_cards_index;
+  int8_t current_player;
+  int8_t captured_mond_player;
+  // the i-th bit is set while talon_.at(i) is still part of the talon
+  uint8_t talon_positions;
+  bool finished;
+  // cards of the last resolved trick, used for the ultimo bonuses
+  CardSet last_trick_cards;
+};
+
+DoubleDummySolver::DoubleDummySolver(int64_t max_nodes)
+    : max_nodes_(max_nodes) {}
+
+DoubleDummyResult DoubleDummySolver::Solve(const TarokState& state,
+                                           open_spiel::Player player) {
+  DoubleDummyResult result;
+  if (state.IsTerminal()) {
+    result.value = static_cast<int>(state.Returns().at(player));
+    result.best_action = open_spiel::kInvalidAction;
+    result.lower = result.value;
+    result.upper = result.value;
+    return result;
+  }
+  return SolveObjective(state, player, false);
+}
+
+DoubleDummyResult DoubleDummySolver::SolveContractWon(
+    const TarokState& state, open_spiel::Player player) {
+  SPIEL_CHECK_TRUE(state.SelectedContractName() != ContractName::kKlop);
+  return SolveObjective(state, player, true);
+}
+
+DoubleDummyResult DoubleDummySolver::SolveObjective(
+    const TarokState& state, open_spiel::Player player,
+    bool contract_won_objective) {
+  DoubleDummyResult result;
+  Bounds bounds = NullWindowSearches(
+      StartSearch(state, player, contract_won_objective));
+  result.value = bounds.lower;
+  result.best_action = bounds.best_action;
+  result.solved = !stopped_;
+  result.lower = bounds.lower;
+  result.upper = bounds.upper;
+  return result;
+}
+
+std::vector<std::pair<open_spiel::Action, int>>
+DoubleDummySolver::ActionValues(const TarokState& state,
+                                open_spiel::Player player) {
+  std::vector<std::pair<open_spiel::Action, int>> action_values;
+  if (state.IsTerminal()) return action_values;
+  SearchState search_state = StartSearch(state, player, false);
+  for (CardSet actions = state.LegalActionsBitmask(); actions != kEmptyCardSet;
+       actions &= actions - 1) {
+    open_spiel::Action action = LowestCardAction(actions);
+    SearchState child = search_state;
+    ApplyAction(&child, action);
+    action_values.push_back({action, NullWindowSearches(child).lower});
+  }
+  if (stopped_) action_values.clear();
+  return action_values;
+}
+
+int64_t DoubleDummySolver::NumNodes() const { return num_nodes_; }
+
+DoubleDummySolver::SearchState DoubleDummySolver::StartSearch(
+    const TarokState& state, open_spiel::Player player,
+    bool contract_won_objective) {
+  SPIEL_CHECK_TRUE(state.CurrentGamePhase() == GamePhase::kTricksPlaying);
+  SPIEL_CHECK_GE(player, 0);
+  SPIEL_CHECK_LT(player, state.NumPlayers());
+  // positions hold everything but the player and the objective so stored
+  // bounds stay valid across solves of the same player and objective, the
+  // table is also cleared once it holds more positions than a single search
+  // may visit to keep its memory bounded
+  if (player != player_ || contract_won_objective != contract_won_objective_ ||
+      (max_nodes_ > 0 &&
+       transposition_table_.size() > static_cast<size_t>(max_nodes_))) {
+    player_ = player;
+    contract_won_objective_ = contract_won_objective;
+    transposition_table_.clear();
+  }
+  search_start_num_nodes_ = num_nodes_;
+  stopped_ = false;
+
+  num_players_ = state.NumPlayers();
+  contract_ = &kContracts.at(static_cast<int>(state.SelectedContractName()));
+  taroks_are_trumps_ = contract_->name != ContractName::kColourValatWithout;
+  declarer_ = state.Declarer();
+  declarer_partner_ = state.DeclarerPartner();
+  called_king_ = state.CalledKing();
+  called_king_in_talon_ = state.CalledKingInTalon();
+  talon_.clear();
+  for (open_spiel::Action action : state.Talon()) talon_.push_back(action);
+
+  SearchState search_state{};
+  for (int i = 0; i < num_players_; i++) {
+    search_state.players_cards.at(i) = state.PlayerCardSet(i);
+    search_state.collected_cards_summaries.at(Side(i)) +=
+        CollectedCardsSummary(state.CollectedCardSet(i));
+  }
+  for (open_spiel::Action action : state.TrickCards()) {
+    search_state.trick_cards.push_back(action);
+    int index = search_state.trick_cards.size() - 1;
+    if (index > 0) {
+      search_state.winning_trick_cards_index = NextWinningTrickCardsIndex(
+          search_state.trick_cards, index,
+          search_state.winning_trick_cards_index, taroks_are_trumps_);
+    }
+  }
+  search_state.current_player = state.CurrentPlayer();
+  search_state.captured_mond_player = state.CapturedMondPlayer();
+  search_state.talon_positions = (1 << talon_.size()) - 1;
+  talon_card_set_ = talon_.ToCardSet();
+  talon_summary_ = CollectedCardsSummary(talon_card_set_);
+  collectable_cards_summary_ =
+      talon_summary_ +
+      CollectedCardsSummary(search_state.trick_cards.ToCardSet());
+  for (int i = 0; i < num_players_; i++) {
+    collectable_cards_summary_ +=
+        search_state.collected_cards_summaries.at(i) +
+        CollectedCardsSummary(state.PlayerCardSet(i));
+  }
+  return search_state;
+}
+
+DoubleDummySolver::Bounds DoubleDummySolver::NullWindowSearches(
+    const SearchState& state) {
+  if (state.finished) {
+    int value = Value(state);
+    return {value, value, open_spiel::kInvalidAction};
+  }
+  // bisects the range of possible values with null window searches, each of
+  // them only proves whether the value is below or above the window so they
+  // prune much more than a single search with a full window, bounds stored in
+  // the transposition table are reused by the subsequent searches
+  bool maximizing = IsMaximizing(state.current_player);
+  auto [lower, upper] = ValueBounds(state);
+  Bounds bounds{lower, upper, open_spiel::kInvalidAction};
+  while (bounds.lower < bounds.upper) {
+    int beta = bounds.lower + (bounds.upper - bounds.lower + 1) / 2;
+    open_spiel::Action action;
+    int value = Search(state, beta - 1, beta, &action);
+    // the bounds proven so far are kept when the node limit is reached
+    if (stopped_) break;
+    if (value >= beta) {
+      bounds.lower = value;
+      // the action proves the lower bound of a maximizing player
+      if (maximizing) bounds.best_action = action;
+    } else {
+      bounds.upper = value;
+      if (!maximizing) bounds.best_action = action;
+    }
+  }
+  // the value is known without searching if the bounds already meet
+  if (bounds.best_action == open_spiel::kInvalidAction && !stopped_) {
+    Search(state, bounds.lower - 1, bounds.lower + 1, &bounds.best_action);
+  }
+  return bounds;
+}
+
+int DoubleDummySolver::Search(const SearchState& state, int alpha, int beta,
+                              open_spiel::Action* best_action) {
+  num_nodes_++;
+  if (max_nodes_ > 0 && num_nodes_ - search_start_num_nodes_ > max_nodes_)
+    stopped_ = true;
+  if (stopped_) return 0;
+  if (state.finished) return Value(state);
+
+  // the root has to be searched to find its best action
+  auto [lower, upper] = ValueBounds(state);
+  if (best_action == nullptr) {
+    if (lower >= beta) return lower;
+    if (upper <= alpha) return upper;
+  }
+  // positions are only stored at trick boundaries as transpositions within a
+  // trick are impossible
+  Bounds* bounds = nullptr;
+  CardSet cards_in_play = kEmptyCardSet;
+  if (state.trick_cards.empty()) {
+    for (int i = 0; i < num_players_; i++)
+      cards_in_play |= state.players_cards.at(i);
+    bounds = &transposition_table_
+                  .try_emplace(ToPosition(state, cards_in_play),
+                               Bounds{lower, upper, open_spiel::kInvalidAction})
+                  .first->second;
+    if (best_action == nullptr) {
+      if (bounds->lower >= beta || bounds->lower == bounds->upper)
+        return bounds->lower;
+      if (bounds->upper <= alpha) return bounds->upper;
+      alpha = std::max(alpha, bounds->lower);
+      beta = std::min(beta, bounds->upper);
+    }
+  }
+  int search_alpha = alpha;
+  int search_beta = beta;
+
+  bool maximizing = IsMaximizing(state.current_player);
+  CardActions<16> actions = OrderedActions(
+      state, bounds != nullptr ? FromPositionAction(cards_in_play,
+                                                    bounds->best_action)
+                               : open_spiel::kInvalidAction);
+
+  int value = maximizing ? kMinValue : kMaxValue;
+  open_spiel::Action value_action = open_spiel::kInvalidAction;
+  for (open_spiel::Action action : actions) {
+    SearchState child = state;
+    ApplyAction(&child, action);
+    int action_value = Search(child, alpha, beta, nullptr);
+    // values of unfinished searches mustn't be stored
+    if (stopped_) return 0;
+
+    if (maximizing ? action_value > value : action_value < value) {
+      value = action_value;
+      value_action = action;
+    }
+    if (maximizing)
+      alpha = std::max(alpha, value);
+    else
+      beta = std::min(beta, value);
+    if (alpha >= beta) break;
+  }
+
+  if (bounds != nullptr) {
+    if (value <= search_alpha) {
+      bounds->upper = value;
+    } else if (value >= search_beta) {
+      bounds->lower = value;
+    } else {
+      bounds->lower = value;
+      bounds->upper = value;
+    }
+    bounds->best_action = ToPositionAction(cards_in_play, value_action);
+  }
+  if (best_action != nullptr) *best_action = value_action;
+  return value;
+}
+
+void DoubleDummySolver::ApplyAction(SearchState* state,
+                                    open_spiel::Action action) const {
+  state->players_cards.at(state->current_player) &=
+      ~CardActionToCardSet(action);
+  state->trick_cards.push_back(action);
+  int index = state->trick_cards.size() - 1;
+  state->winning_trick_cards_index =
+      index == 0 ? 0
+                 : NextWinningTrickCardsIndex(state->trick_cards, index,
+                                              state->winning_trick_cards_index,
+                                              taroks_are_trumps_);
+  if (state->trick_cards.size() < num_players_) {
+    state->current_player = (state->current_player + 1) % num_players_;
+    return;
+  }
+  ResolveTrick(state);
+}
+
+void DoubleDummySolver::ResolveTrick(SearchState* state) const {
+  // the current player played the last card so the next one opened the trick,
+  // see TarokState::ResolveTrick() for the rules
+  open_spiel::Player trick_opener = (state->current_player + 1) % num_players_;
+  open_spiel::Player trick_winner =
+      (trick_opener + state->winning_trick_cards_index) % num_players_;
+  open_spiel::Action winning_action =
+      state->trick_cards.at(state->winning_trick_cards_index);
+  uint32_t& summary = state->collected_cards_summaries.at(Side(trick_winner));
+  state->last_trick_cards = state->trick_cards.ToCardSet();
+  for (open_spiel::Action action : state->trick_cards)
+    summary += kCardSummaries[action];
+
+  if (contract_->name == ContractName::kKlop && state->talon_positions != 0) {
+    int gift_position = __builtin_ctz(state->talon_positions);
+    summary += kCardSummaries[talon_.at(gift_position)];
+    state->talon_positions &= ~(1 << gift_position);
+  } else if (winning_action == called_king_ && called_king_in_talon_) {
+    for (int i = 0; i < talon_.size(); i++) {
+      if ((state->talon_positions & (1 << i)) == 0) continue;
+      summary += kCardSummaries[talon_.at(i)];
+      if (talon_.at(i) == kMondAction)
+        state->captured_mond_player = open_spiel::kInvalidPlayer;
+    }
+    state->talon_positions = 0;
+  } else if ((contract_->NeedsTalonExchange() ||
+              contract_->name == ContractName::kSoloWithout) &&
+             (winning_action == kSkisAction ||
+              winning_action == kPagatAction)) {
+    for (int i = 0; i < state->trick_cards.size(); i++) {
+      if (state->trick_cards.at(i) == kMondAction)
+        state->captured_mond_player = (trick_opener + i) % num_players_;
+    }
+  }
+
+  state->trick_cards.clear();
+  state->current_player = trick_winner;
+  state->finished =
+      state->players_cards.at(trick_winner) == kEmptyCardSet ||
+      ((contract_->name == ContractName::kBeggar ||
+        contract_->name == ContractName::kOpenBeggar) &&
+       trick_winner == declarer_) ||
+      ((contract_->name == ContractName::kColourValatWithout ||
+        contract_->name == ContractName::kValatWithout) &&
+       trick_winner != declarer_);
+}
+
+int DoubleDummySolver::Side(open_spiel::Player player) const {
+  if (contract_->name == ContractName::kKlop) return player;
+  return player == declarer_ || player == declarer_partner_ ? 0 : 1;
+}
+
+bool DoubleDummySolver::IsMaximizing(open_spiel::Player player) const {
+  if (contract_->name == ContractName::kKlop) return player == player_;
+  return Side(player) == Side(player_);
+}
+
+int DoubleDummySolver::Value(const SearchState& state) const {
+  if (contract_won_objective_) {
+    bool declarer_won = DeclarerWon(state.collected_cards_summaries.at(0));
+    return declarer_won == (Side(player_) == 0) ? 1 : -1;
+  }
+  // mirrors TarokState::Returns() on the summaries of collected cards
+  int value = 0;
+  if (contract_->name == ContractName::kKlop) {
+    std::array<int, 4> scores{};
+    bool any_player_won_or_lost = false;
+    for (int i = 0; i < num_players_; i++) {
+      int points = SummaryCardPoints(state.collected_cards_summaries.at(i));
+      if (points > 35) {
+        any_player_won_or_lost = true;
+        scores.at(i) = -70;
+      } else if (points == 0) {
+        any_player_won_or_lost = true;
+        scores.at(i) = 70;
+      } else {
+        scores.at(i) = -points;
+      }
+    }
+    value = scores.at(player_);
+    if (any_player_won_or_lost && std::abs(value) != 70) value = 0;
+  } else if (Side(player_) == 0) {
+    // the last trick winner is the current player
+    int ultimo = 0;
+    if (called_king_ != open_spiel::kInvalidAction &&
+        CardActionInCardSet(called_king_, state.last_trick_cards)) {
+      ultimo = 10;
+    } else if (CardActionInCardSet(kPagatAction, state.last_trick_cards)) {
+      ultimo = 25;
+    }
+    if (Side(state.current_player) != 0) ultimo = -ultimo;
+    value = DeclarerScore(state.collected_cards_summaries.at(0),
+                          state.collected_cards_summaries.at(1), ultimo);
+  }
+  if (state.captured_mond_player == player_) value -= 20;
+  return value;
+}
+
+bool DoubleDummySolver::DeclarerWon(uint32_t collected) const {
+  if (contract_->name == ContractName::kBeggar ||
+      contract_->name == ContractName::kOpenBeggar) {
+    return SummaryCardSetSize(collected) == 0;
+  } else if (contract_->name == ContractName::kColourValatWithout ||
+             contract_->name == ContractName::kValatWithout) {
+    return SummaryCardSetSize(collected) == 48;
+  }
+  return SummaryCardPoints(collected) > 35;
+}
+
+int DoubleDummySolver::DeclarerScore(uint32_t collected,
+                                     uint32_t opposite_collected,
+                                     int ultimo) const {
+  if (!contract_->NeedsTalonExchange())
+    return DeclarerWon(collected) ? contract_->score : -contract_->score;
+
+  int bonuses;
+  if (SummaryCardSetSize(collected) == 48) {
+    bonuses = 250;
+  } else if (SummaryCardSetSize(opposite_collected) == 48) {
+    bonuses = -250;
+  } else {
+    bonuses = ultimo;
+    if ((collected & kSummaryKingsBits) == kSummaryKingsBits)
+      bonuses += 10;
+    else if ((opposite_collected & kSummaryKingsBits) == kSummaryKingsBits)
+      bonuses -= 10;
+    if ((collected & kSummaryTrulaBits) == kSummaryTrulaBits)
+      bonuses += 10;
+    else if ((opposite_collected & kSummaryTrulaBits) == kSummaryTrulaBits)
+      bonuses -= 10;
+  }
+  int card_points = SummaryCardPoints(collected);
+  int score = card_points - 35;
+  if (card_points > 35)
+    score += contract_->score;
+  else
+    score -= contract_->score;
+  return score + bonuses;
+}
+
+std::pair<int, int> DoubleDummySolver::ValueBounds(
+    const SearchState& state) const {
+  // scores are bounded by the cards each team may still collect, there is no
+  // such ordering in klop where each player wins or loses on their own
+  if (contract_->name == ContractName::kKlop) return {kMinValue, kMaxValue};
+  CardSet cards_in_play = state.trick_cards.ToCardSet();
+  for (int i = 0; i < num_players_; i++)
+    cards_in_play |= state.players_cards.at(i);
+  bool talon_in_play = state.talon_positions != 0;
+
+  int lower = 0;
+  int upper = 0;
+  if (Side(player_) == 0 || contract_won_objective_) {
+    uint32_t collected = state.collected_cards_summaries.at(0);
+    uint32_t opposite_collected = state.collected_cards_summaries.at(1);
+    // cards only move from play to the collected cards, the talon only goes
+    // to the declarer together with the called king
+    uint32_t summary_in_play =
+        collectable_cards_summary_ - collected - opposite_collected -
+        (talon_in_play ? talon_summary_ : 0);
+    uint32_t max_collected = collected + summary_in_play;
+    if (talon_in_play && called_king_in_talon_)
+      max_collected += talon_summary_;
+    uint32_t max_opposite_collected = opposite_collected + summary_in_play;
+    int min_points = SummaryCardPoints(collected);
+    int max_points = SummaryCardPoints(max_collected);
+
+    // whether the declarer wins is decided by either the points or the
+    // number of collected cards
+    bool can_win;
+    bool can_lose;
+    if (contract_->name == ContractName::kBeggar ||
+        contract_->name == ContractName::kOpenBeggar) {
+      can_win = SummaryCardSetSize(collected) == 0;
+      can_lose = cards_in_play != kEmptyCardSet;
+    } else if (contract_->name == ContractName::kColourValatWithout ||
+               contract_->name == ContractName::kValatWithout) {
+      can_win = SummaryCardSetSize(max_collected) >= 48;
+      can_lose = SummaryCardSetSize(collected) != 48;
+    } else {
+      can_win = max_points > 35;
+      can_lose = min_points <= 35;
+    }
+    if (contract_won_objective_) {
+      if (Side(player_) != 0) std::swap(can_win, can_lose);
+      return {can_lose ? -1 : 1, can_win ? 1 : -1};
+    }
+    if (!contract_->NeedsTalonExchange()) {
+      lower = can_lose ? -contract_->score : contract_->score;
+      upper = can_win ? contract_->score : -contract_->score;
+    } else {
+      auto base_score = [this](int card_points) {
+        return card_points - 35 +
+               (card_points > 35 ? contract_->score : -contract_->score);
+      };
+      // either team may still collect all kings or trula and the ultimo
+      // bonuses are only known once the last trick is played
+      int ultimo = 0;
+      if (CardActionInCardSet(kPagatAction, cards_in_play)) {
+        ultimo = 25;
+      } else if (called_king_ != open_spiel::kInvalidAction &&
+                 CardActionInCardSet(called_king_, cards_in_play)) {
+        ultimo = 10;
+      }
+      int min_bonuses = -ultimo;
+      int max_bonuses = ultimo;
+      for (uint32_t bits : {kSummaryKingsBits, kSummaryTrulaBits}) {
+        if ((collected & bits) == bits) {
+          min_bonuses += 10;
+          max_bonuses += 10;
+        } else if ((opposite_collected & bits) == bits) {
+          min_bonuses -= 10;
+          max_bonuses -= 10;
+        } else {
+          if ((max_collected & bits) == bits) max_bonuses += 10;
+          if ((max_opposite_collected & bits) == bits) min_bonuses -= 10;
+        }
+      }
+      // valat replaces all other bonuses
+      if (SummaryCardSetSize(opposite_collected) == 0) max_bonuses = 250;
+      if (SummaryCardSetSize(max_opposite_collected) >= 48) min_bonuses = -250;
+      lower = base_score(min_points) + min_bonuses;
+      upper = base_score(max_points) + max_bonuses;
+    }
+  }
+  if (CardActionInCardSet(kMondAction, cards_in_play) ||
+      (talon_in_play && CardActionInCardSet(kMondAction, talon_card_set_))) {
+    lower -= 20;
+  } else if (state.captured_mond_player == player_) {
+    lower -= 20;
+    upper -= 20;
+  }
+  return {lower, upper};
+}
+
+CardActions<16> DoubleDummySolver::OrderedActions(
+    const SearchState& state, open_spiel::Action first_action) const {
+  CardSet cards = RemoveEquivalentCards(
+      state, LegalTrickCards(state.players_cards.at(state.current_player),
+                             state.trick_cards, contract_->is_negative));
+  CardActions<16> actions;
+  // the best action from a previous search of the same position goes first
+  if (first_action != open_spiel::kInvalidAction &&
+      CardActionInCardSet(first_action, cards)) {
+    actions.push_back(first_action);
+    cards &= ~CardActionToCardSet(first_action);
+  }
+
+  // actions that let the player's team take the trick in positive contracts
+  // or give it away in negative ones are tried first and the most points are
+  // put into such tricks, otherwise the fewest points are given away, trick
+  // openings are scored the same by the trick that follows when all other
+  // players greedily follow this ordering as well
+  open_spiel::Player trick_opener =
+      (state.current_player - state.trick_cards.size() + num_players_) %
+      num_players_;
+  auto trick_score = [&](const CardActions<4>& trick_cards,
+                         int winning_action_i, open_spiel::Player player,
+                         int points) {
+    open_spiel::Player trick_winner =
+        (trick_opener + winning_action_i) % num_players_;
+    bool good_trick = IsMaximizing(trick_winner) == IsMaximizing(player);
+    if (contract_->is_negative) good_trick = !good_trick;
+    return good_trick ? 100 + points : -points;
+  };
+  auto play_greedily = [&](CardActions<4>* trick_cards,
+                           int* winning_action_i) {
+    open_spiel::Player player =
+        (trick_opener + trick_cards->size()) % num_players_;
+    CardSet player_cards =
+        LegalTrickCards(state.players_cards.at(player), *trick_cards,
+                        contract_->is_negative);
+    int best_score = 0;
+    int best_winning_action_i = 0;
+    open_spiel::Action best_action = open_spiel::kInvalidAction;
+    for (; player_cards != kEmptyCardSet; player_cards &= player_cards - 1) {
+      open_spiel::Action action = LowestCardAction(player_cards);
+      trick_cards->push_back(action);
+      int next_winning_action_i = NextWinningTrickCardsIndex(
+          *trick_cards, trick_cards->size() - 1, *winning_action_i,
+          taroks_are_trumps_);
+      int score = trick_score(*trick_cards, next_winning_action_i, player,
+                              CardActionPoints(action));
+      if (best_action == open_spiel::kInvalidAction || score > best_score) {
+        best_score = score;
+        best_winning_action_i = next_winning_action_i;
+        best_action = action;
+      }
+      trick_cards->pop_back();
+    }
+    trick_cards->push_back(best_action);
+    *winning_action_i = best_winning_action_i;
+  };
+
+  std::array<std::pair<int, int8_t>, 16> scored_actions;
+  int num_scored = 0;
+  for (CardSet remaining = cards; remaining != kEmptyCardSet;
+       remaining &= remaining - 1) {
+    open_spiel::Action action = LowestCardAction(remaining);
+    CardActions<4> trick_cards = state.trick_cards;
+    trick_cards.push_back(action);
+    int winning_action_i =
+        trick_cards.size() == 1
+            ? 0
+            : NextWinningTrickCardsIndex(trick_cards, trick_cards.size() - 1,
+                                         state.winning_trick_cards_index,
+                                         taroks_are_trumps_);
+    int score;
+    if (state.trick_cards.empty()) {
+      while (trick_cards.size() < num_players_)
+        play_greedily(&trick_cards, &winning_action_i);
+      int points = 0;
+      for (open_spiel::Action trick_action : trick_cards)
+        points += CardActionPoints(trick_action);
+      score = trick_score(trick_cards, winning_action_i, state.current_player,
+                          points);
+    } else {
+      score = trick_score(trick_cards, winning_action_i, state.current_player,
+                          CardActionPoints(action));
+    }
+    scored_actions.at(num_scored++) = {score, action};
+  }
+  std::sort(scored_actions.begin(), scored_actions.begin() + num_scored,
+            std::greater<>());
+  for (int i = 0; i < num_scored; i++) {
+    actions.push_back(scored_actions.at(i).second);
+  }
+  return actions;
+}
+
+CardSet DoubleDummySolver::RemoveEquivalentCards(const SearchState& state,
+                                                 CardSet cards) const {
+  // two cards are interchangeable when they are of the same suit and points,
+  // no card that is still in play ranks between them and neither of them
+  // carries any bonuses, note that ranks within a suit follow card actions
+  CardSet cards_in_play = state.trick_cards.ToCardSet();
+  for (auto const& player_cards : state.players_cards) {
+    cards_in_play |= player_cards;
+  }
+
+  CardSet reduced_cards = cards;
+  open_spiel::Action previous_action = open_spiel::kInvalidAction;
+  for (CardSet remaining = cards; remaining != kEmptyCardSet;
+       remaining &= remaining - 1) {
+    open_spiel::Action action = LowestCardAction(remaining);
+    if (previous_action != open_spiel::kInvalidAction &&
+        !CardActionInCardSet(action, kTrulaCardSet) &&
+        !CardActionInCardSet(previous_action, kTrulaCardSet) &&
+        CardActionSuit(action) == CardActionSuit(previous_action) &&
+        CardActionPoints(action) == CardActionPoints(previous_action)) {
+      CardSet cards_between = (CardActionToCardSet(action) - 1) &
+                              ~(CardActionToCardSet(previous_action + 1) - 1);
+      if ((cards_between & cards_in_play) == kEmptyCardSet)
+        reduced_cards &= ~CardActionToCardSet(action);
+    }
+    previous_action = action;
+  }
+  return reduced_cards;
+}
+
+DoubleDummySolver::Position DoubleDummySolver::ToPosition(
+    const SearchState& state, CardSet cards_in_play) const {
+  Position position{};
+  for (int i = 0; i < num_players_; i++) {
+    CardSet player_cards = state.players_cards.at(i);
+    CardSet& position_cards = position.players_cards.at(i);
+    position_cards = player_cards & ~kPlainCardSet;
+    for (CardSet cards = player_cards & kPlainCardSet; cards != kEmptyCardSet;
+         cards &= cards - 1) {
+      position_cards |= CardActionToCardSet(
+          ToPositionAction(cards_in_play, LowestCardAction(cards)));
+    }
+  }
+  position.collected_cards_summaries = state.collected_cards_summaries;
+  for (int i = 0; i < talon_.size(); i++) {
+    if (state.talon_positions & (1 << i))
+      position.talon.push_back(talon_.at(i));
+  }
+  position.current_player = state.current_player;
+  position.captured_mond_player = state.captured_mond_player;
+  position.declarer = declarer_;
+  position.declarer_partner = declarer_partner_;
+  position.selected_contract = static_cast<int8_t>(contract_->name);
+  position.called_king = called_king_;
+  position.called_king_in_talon = called_king_in_talon_;
+  return position;
+}
+
+bool DoubleDummySolver::Position::operator==(const Position& other) const {
+  return players_cards == other.players_cards &&
+         collected_cards_summaries == other.collected_cards_summaries &&
+         talon == other.talon &&
+         current_player == other.current_player &&
+         captured_mond_player == other.captured_mond_player &&
+         declarer == other.declarer &&
+         declarer_partner == other.declarer_partner &&
+         selected_contract == other.selected_contract &&
+         called_king == other.called_king &&
+         called_king_in_talon == other.called_king_in_talon;
+}
+
+size_t DoubleDummySolver::PositionHash::operator()(
+    const Position& position) const {
+  auto byte = [](int8_t value, int i) {
+    return static_cast<uint64_t>(static_cast<uint8_t>(value)) << (8 * i);
+  };
+  uint64_t hash = byte(position.current_player, 0) |
+                  byte(position.captured_mond_player, 1) |
+                  byte(position.declarer, 2) |
+                  byte(position.declarer_partner, 3) |
+                  byte(position.selected_contract, 4) |
+                  byte(position.called_king, 5) |
+                  byte(position.called_king_in_talon, 6);
+  auto combine = [&hash](CardSet cards) {
+    hash = (hash ^ cards) * 0x9E3779B97F4A7C15u;
+    hash ^= hash >> 29;
+  };
+  for (auto const& cards : position.players_cards) combine(cards);
+  for (int i = 0; i < 4; i += 2) {
+    combine(position.collected_cards_summaries.at(i) |
+            (static_cast<uint64_t>(position.collected_cards_summaries.at(i + 1))
+             << 32));
+  }
+  combine(position.talon.ToCardSet());
+  return hash;
+}
+
+}  // namespace tarok
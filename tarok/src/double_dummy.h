@@ -0,0 +1,181 @@
+/* Copyright 2020 Semantic Weights. All rights reserved. */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "open_spiel/spiel.h"
+#include "src/cards.h"
+#include "src/contracts.h"
+#include "src/state.h"
+
+namespace tarok {
+
+struct DoubleDummyResult {
+  // the player's return (i.e. including the captured mond penalty) at the end
+  // of the game when all players play optimally
+  int value;
+  // one of the actions that achieve the value, open_spiel::kInvalidAction if
+  // the state is terminal
+  open_spiel::Action best_action;
+  // false if the search was stopped due to the node limit in which case the
+  // value is only known to lie within [lower, upper] and the action is
+  // meaningless
+  bool solved = true;
+  // bounds of the value proven by the searches, both equal to the value if
+  // solved
+  int lower;
+  int upper;
+};
+
+// solves the tricks playing phase of a state with all cards known to all
+// players (i.e. double dummy) by alpha-beta search over the actual game rules,
+// the solved value is the return of the given player where the player's team
+// maximises it and all other players minimise it, teams are the declarer and
+// the declarer's partner against the rest in all contracts but klop where
+// every player plays for themselves, i.e. the solution is exact in all team
+// contracts and paranoid in klop
+//
+// the search doesn't apply actions to TarokState but to a lean copy-on-make
+// search state that only holds the players' cards, the current trick and the
+// points and bonus cards collected by each team, contract rules are fixed for
+// the whole search and trick rules are shared with TarokState (see tricks.h)
+//
+// the value is found by bisecting the range of returns with null window
+// alpha-beta searches, bounds of positions at trick boundaries are kept in a
+// transposition table where positions only differ in the points and bonus
+// cards collected by each team instead of the actual cards, actions are
+// ordered by the best action of the previous search and by whether they take
+// the trick for the player's team and only one card out of each group of
+// touching cards of equal points in the same hand is searched, subtrees whose
+// value can't reach the search window even if one team took all of the
+// remaining cards are cut off, full deals are within reach in contracts that
+// are decided early (e.g. beggar) while others can take many millions of
+// nodes, solving times vary a lot between deals so the node limit should be
+// set when full deals are solved
+//
+// the transposition table is kept between solves of the same player since
+// positions contain everything that affects the rest of the game so that e.g.
+// all contracts of a deal can share it, it is cleared otherwise or when it
+// outgrows the node limit
+class DoubleDummySolver {
+ public:
+  // searches are stopped once they visit more than max_nodes positions, 0 means
+  // no limit
+  explicit DoubleDummySolver(int64_t max_nodes = 0);
+
+  DoubleDummyResult Solve(const TarokState& state, open_spiel::Player player);
+  // solves whether the declarer's team wins the contract (i.e. collects more
+  // than 35 points, no cards in beggar contracts or all cards in valat
+  // contracts) instead of the return, the value is 1 if the player's team wins
+  // and -1 otherwise, bonuses and the captured mond penalty are ignored so a
+  // single null window search is needed which usually visits far fewer
+  // positions than Solve(), the state has to be in the tricks playing phase
+  // of a contract other than klop
+  DoubleDummyResult SolveContractWon(const TarokState& state,
+                                     open_spiel::Player player);
+  // values of all legal actions of the current player, meant for perfect
+  // information Monte Carlo where values of the same action are summed up over
+  // many sampled deals, empty if the node limit was reached
+  std::vector<std::pair<open_spiel::Action, int>> ActionValues(
+      const TarokState& state, open_spiel::Player player);
+
+  // number of positions visited since the solver was created
+  int64_t NumNodes() const;
+
+ private:
+  struct SearchState;
+  // everything about a position at a trick boundary that affects the outcome
+  // of the rest of the game
+  struct Position {
+    bool operator==(const Position& other) const;
+
+    std::array<CardSet, 4> players_cards;
+    // summaries of cards collected by each team or each player in klop
+    std::array<uint32_t, 4> collected_cards_summaries;
+    // remaining talon cards in the order in which they were dealt
+    CardActions<6> talon;
+    int8_t current_player;
+    int8_t captured_mond_player;
+    int8_t declarer;
+    int8_t declarer_partner;
+    int8_t selected_contract;
+    int8_t called_king;
+    bool called_king_in_talon;
+  };
+  struct PositionHash {
+    size_t operator()(const Position& position) const;
+  };
+  // the searched value lies within [lower, upper]
+  struct Bounds {
+    int lower;
+    int upper;
+    open_spiel::Action best_action;
+  };
+
+  DoubleDummyResult SolveObjective(const TarokState& state,
+                                   open_spiel::Player player,
+                                   bool contract_won_objective);
+  // sets up the contract rules and returns the search state of the given state
+  SearchState StartSearch(const TarokState& state, open_spiel::Player player,
+                          bool contract_won_objective);
+  // the bounds are only narrowed down to the value if the searches aren't
+  // stopped, the best action is kInvalidAction if the state is terminal
+  Bounds NullWindowSearches(const SearchState& state);
+  // fail-soft alpha-beta search that also returns the best action of the
+  // searched position if best_action is set
+  int Search(const SearchState& state, int alpha, int beta,
+             open_spiel::Action* best_action);
+  void ApplyAction(SearchState* state, open_spiel::Action action) const;
+  void ResolveTrick(SearchState* state) const;
+  // the team of the player or the player itself in klop
+  int Side(open_spiel::Player player) const;
+  bool IsMaximizing(open_spiel::Player player) const;
+  // the player's return in a finished game or whether the player's team won
+  // with the contract won objective
+  int Value(const SearchState& state) const;
+  // whether the declarer's team won given the summary of its collected cards
+  bool DeclarerWon(uint32_t collected) const;
+  // the score of the declarer's team given the summaries of cards collected by
+  // the team and by the opponents and the ultimo bonus of the team
+  int DeclarerScore(uint32_t collected, uint32_t opposite_collected,
+                    int ultimo) const;
+  // bounds of the value given that either team collects all cards in play
+  std::pair<int, int> ValueBounds(const SearchState& state) const;
+  // legal actions of the current player in the order in which they are
+  // searched
+  CardActions<16> OrderedActions(const SearchState& state,
+                                 open_spiel::Action first_action) const;
+  CardSet RemoveEquivalentCards(const SearchState& state, CardSet cards) const;
+  Position ToPosition(const SearchState& state, CardSet cards_in_play) const;
+
+  const int64_t max_nodes_;
+  open_spiel::Player player_ = open_spiel::kInvalidPlayer;
+  // see SolveContractWon()
+  bool contract_won_objective_ = false;
+  // rules of the searched contract
+  int num_players_ = 0;
+  const Contract* contract_ = nullptr;
+  bool taroks_are_trumps_ = true;
+  open_spiel::Player declarer_ = open_spiel::kInvalidPlayer;
+  open_spiel::Player declarer_partner_ = open_spiel::kInvalidPlayer;
+  open_spiel::Action called_king_ = open_spiel::kInvalidAction;
+  bool called_king_in_talon_ = false;
+  // remaining talon cards when the search started
+  CardActions<6> talon_;
+  CardSet talon_card_set_ = kEmptyCardSet;
+  uint32_t talon_summary_ = 0;
+  // summary of the cards collected so far, the cards in play and the talon,
+  // it stays the same throughout the search
+  uint32_t collectable_cards_summary_ = 0;
+  int64_t search_start_num_nodes_ = 0;
+  bool stopped_ = false;
+  std::unordered_map<Position, Bounds, PositionHash> transposition_table_;
+  int64_t num_nodes_ = 0;
+};
+
+}  // namespace tarok
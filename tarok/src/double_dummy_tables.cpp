@@ -0,0 +1,242 @@
+/* Copyright 2020 Semantic Weights. All rights reserved. */
+
+#include "src/double_dummy_tables.h"
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "src/cards.h"
+#include "src/double_dummy.h"
+
+namespace tarok {
+
+bool DoubleDummyTableEntry::operator==(
+    const DoubleDummyTableEntry& other) const {
+  return contract == other.contract && declarer == other.declarer &&
+         called_king == other.called_king && talon_set == other.talon_set &&
+         won == other.won && heuristic_discards == other.heuristic_discards &&
+         lower == other.lower && upper == other.upper;
+}
+
+// returns the state after the declarer bids the contract and all other players
+// pass or nullptr if the declarer can't get the contract this way
+static std::unique_ptr<TarokState> StateAfterBidding(
+    const TarokState& dealt_state, open_spiel::Player declarer, int contract) {
+  auto clone = dealt_state.Clone();
+  auto* state = static_cast<TarokState*>(clone.get());
+  while (state->CurrentGamePhase() == GamePhase::kBidding) {
+    open_spiel::Action action =
+        state->CurrentPlayer() == declarer ? contract + 1 : kBidPassAction;
+    if (!CardActionInCardSet(action, state->LegalActionsBitmask()))
+      return nullptr;
+    state->ApplyTrustedAction(action);
+  }
+  clone.release();
+  return std::unique_ptr<TarokState>(state);
+}
+
+// discards the card worth the least points, ties are broken in favour of cards
+// from the shortest suit since voiding suits allows trumping them later on
+static void DiscardCard(TarokState* state) {
+  CardSet player_cards = kEmptyCardSet;
+  for (auto const& action : state->PlayerCards(state->CurrentPlayer()))
+    player_cards |= CardActionToCardSet(action);
+  open_spiel::Action discarded_action = open_spiel::kInvalidAction;
+  std::tuple<int, int> discarded_key;
+  for (ActionBitmask actions = state->LegalActionsBitmask(); actions != 0;
+       actions &= actions - 1) {
+    open_spiel::Action action = LowestCardAction(actions);
+    std::tuple<int, int> key{
+        CardActionPoints(action),
+        CardSetSize(player_cards & SuitToCardSet(CardActionSuit(action)))};
+    if (discarded_action == open_spiel::kInvalidAction ||
+        key < discarded_key) {
+      discarded_action = action;
+      discarded_key = key;
+    }
+  }
+  state->ApplyTrustedAction(discarded_action);
+}
+
+// won of the declarer given the contract is solved after the talon exchange
+static int8_t SolveWon(const TarokState& state, DoubleDummySolver* solver,
+                       const DoubleDummyTableEntry& entry) {
+  if (state.SelectedContractName() == ContractName::kKlop) return 0;
+  auto result = solver->SolveContractWon(state, entry.declarer);
+  if (!result.solved) return 0;
+  return result.value;
+}
+
+static void SolveEntry(const TarokState& state, DoubleDummySolver* solver,
+                       DoubleDummyTableEntry* entry) {
+  if (state.CurrentGamePhase() != GamePhase::kTalonExchange) {
+    entry->won = SolveWon(state, solver, *entry);
+    auto result = solver->Solve(state, entry->declarer);
+    entry->lower = result.lower;
+    entry->upper = result.upper;
+    return;
+  }
+
+  entry->heuristic_discards = true;
+  // the declarer loses unless any of the talon sets either wins or is unknown
+  entry->won = -1;
+  for (ActionBitmask talon_sets = state.LegalActionsBitmask();
+       talon_sets != 0; talon_sets &= talon_sets - 1) {
+    open_spiel::Action talon_set = LowestCardAction(talon_sets);
+    auto clone = state.Clone();
+    auto* exchanged_state = static_cast<TarokState*>(clone.get());
+    exchanged_state->ApplyTrustedAction(talon_set);
+    while (exchanged_state->CurrentGamePhase() == GamePhase::kTalonExchange)
+      DiscardCard(exchanged_state);
+    if (entry->won != 1) {
+      entry->won = std::max(
+          entry->won, SolveWon(*exchanged_state, solver, *entry));
+    }
+    // the declarer's value is the best one among all talon sets
+    auto result = solver->Solve(*exchanged_state, entry->declarer);
+    bool first_talon_set = entry->talon_set == -1;
+    if (first_talon_set || result.upper > entry->upper)
+      entry->upper = result.upper;
+    if (first_talon_set || result.lower > entry->lower) {
+      entry->talon_set = talon_set;
+      entry->lower = result.lower;
+    }
+  }
+}
+
+std::vector<DoubleDummyTable> DoubleDummyTables(const TarokGame& game,
+                                                int64_t first_deal_index,
+                                                int num_deals,
+                                                int64_t max_nodes,
+                                                ThreadPool* pool) {
+  std::vector<DoubleDummyTable> tables(num_deals);
+  // states right after bidding (and king calling) are kept until all solves
+  // are finished
+  std::vector<std::unique_ptr<TarokState>> states;
+  for (int i = 0; i < num_deals; i++) {
+    DoubleDummyTable& table = tables.at(i);
+    table.deal_index = first_deal_index + i;
+    auto dealt_state = game.NewInitialTarokState(table.deal_index);
+    dealt_state->ApplyTrustedAction(0);
+
+    for (open_spiel::Player declarer = 0; declarer < game.NumPlayers();
+         declarer++) {
+      for (int contract = 0; contract < 12; contract++) {
+        auto state = StateAfterBidding(*dealt_state, declarer, contract);
+        if (state == nullptr) continue;
+        DoubleDummyTableEntry entry{static_cast<int8_t>(contract),
+                                    static_cast<int8_t>(declarer),
+                                    open_spiel::kInvalidAction,
+                                    -1,
+                                    0,
+                                    false,
+                                    0,
+                                    0};
+        if (state->CurrentGamePhase() != GamePhase::kKingCalling) {
+          table.entries.push_back(entry);
+          states.push_back(std::move(state));
+          continue;
+        }
+        for (ActionBitmask kings = state->LegalActionsBitmask(); kings != 0;
+             kings &= kings - 1) {
+          entry.called_king = LowestCardAction(kings);
+          auto king_state = state->Clone();
+          king_state->ApplyAction(entry.called_king);
+          table.entries.push_back(entry);
+          states.push_back(std::unique_ptr<TarokState>(
+              static_cast<TarokState*>(king_state.release())));
+        }
+      }
+    }
+  }
+
+  // entries aren't moved anymore so tasks can write to them directly, each
+  // task solves the consecutive entries of a single declarer
+  int state_index = 0;
+  for (auto& table : tables) {
+    for (size_t begin = 0; begin < table.entries.size();) {
+      size_t end = begin + 1;
+      while (end < table.entries.size() &&
+             table.entries.at(end).declarer ==
+                 table.entries.at(begin).declarer) {
+        end++;
+      }
+      DoubleDummyTableEntry* entries = &table.entries.at(begin);
+      const std::unique_ptr<TarokState>* entry_states =
+          &states.at(state_index);
+      int num_entries = end - begin;
+      pool->Submit([entries, entry_states, num_entries, max_nodes]() {
+        DoubleDummySolver solver(max_nodes);
+        for (int i = 0; i < num_entries; i++)
+          SolveEntry(*entry_states[i], &solver, &entries[i]);
+      });
+      state_index += num_entries;
+      begin = end;
+    }
+  }
+  pool->Wait();
+  return tables;
+}
+
+template <typename T>
+static void WriteLittleEndian(T value, std::ostream* out) {
+  auto unsigned_value = static_cast<std::make_unsigned_t<T>>(value);
+  for (size_t i = 0; i < sizeof(T); i++)
+    out->put(static_cast<char>((unsigned_value >> (8 * i)) & 0xFF));
+}
+
+template <typename T>
+static bool ReadLittleEndian(std::istream* in, T* value) {
+  std::make_unsigned_t<T> unsigned_value = 0;
+  for (size_t i = 0; i < sizeof(T); i++) {
+    int byte = in->get();
+    if (byte == std::istream::traits_type::eof()) return false;
+    unsigned_value |= static_cast<std::make_unsigned_t<T>>(byte) << (8 * i);
+  }
+  *value = static_cast<T>(unsigned_value);
+  return true;
+}
+
+void WriteDoubleDummyTable(const DoubleDummyTable& table, std::ostream* out) {
+  SPIEL_CHECK_LE(table.entries.size(), 255);
+  WriteLittleEndian<int64_t>(table.deal_index, out);
+  WriteLittleEndian<uint8_t>(table.entries.size(), out);
+  for (auto const& entry : table.entries) {
+    WriteLittleEndian<int8_t>(entry.contract, out);
+    WriteLittleEndian<int8_t>(entry.declarer, out);
+    WriteLittleEndian<int8_t>(entry.called_king, out);
+    WriteLittleEndian<int8_t>(entry.talon_set, out);
+    WriteLittleEndian<int8_t>(entry.won, out);
+    WriteLittleEndian<uint8_t>(entry.heuristic_discards, out);
+    WriteLittleEndian<int16_t>(entry.lower, out);
+    WriteLittleEndian<int16_t>(entry.upper, out);
+  }
+}
+
+bool ReadDoubleDummyTable(std::istream* in, DoubleDummyTable* table) {
+  uint8_t num_entries;
+  if (!ReadLittleEndian(in, &table->deal_index) ||
+      !ReadLittleEndian(in, &num_entries)) {
+    return false;
+  }
+  table->entries.resize(num_entries);
+  for (auto& entry : table->entries) {
+    uint8_t heuristic_discards;
+    SPIEL_CHECK_TRUE(ReadLittleEndian(in, &entry.contract) &&
+                     ReadLittleEndian(in, &entry.declarer) &&
+                     ReadLittleEndian(in, &entry.called_king) &&
+                     ReadLittleEndian(in, &entry.talon_set) &&
+                     ReadLittleEndian(in, &entry.won) &&
+                     ReadLittleEndian(in, &heuristic_discards) &&
+                     ReadLittleEndian(in, &entry.lower) &&
+                     ReadLittleEndian(in, &entry.upper));
+    entry.heuristic_discards = heuristic_discards != 0;
+  }
+  return true;
+}
+
+}  // namespace tarok
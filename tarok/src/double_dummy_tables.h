@@ -0,0 +1,81 @@
+/* Copyright 2020 Semantic Weights. All rights reserved. */
+
+#pragma once
+
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#include "src/game.h"
+#include "src/thread_pool.h"
+
+namespace tarok {
+
+// double dummy outcome of a single contract, declarer and called king
+struct DoubleDummyTableEntry {
+  bool operator==(const DoubleDummyTableEntry& other) const;
+
+  // index of the contract within InitializeContracts(), i.e. bid action - 1
+  int8_t contract;
+  int8_t declarer;
+  // open_spiel::kInvalidAction if no king is called
+  int8_t called_king;
+  // index of the talon set chosen by the declarer, i.e. the one with the
+  // highest lower bound, -1 if the contract has no talon exchange
+  int8_t talon_set;
+  // 1 if the declarer's team wins the contract with any of the talon sets
+  // (see DoubleDummySolver::SolveContractWon()), -1 if it loses with all of
+  // them and 0 if that's unknown because a search reached the node limit or
+  // in klop where there is no declarer's team
+  int8_t won;
+  // true if the declarer's discards were chosen by the heuristic (see
+  // DoubleDummyTables()) instead of being searched, won and the bounds then
+  // hold for those discards only, i.e. the declarer might do better
+  bool heuristic_discards;
+  // the declarer's return (see DoubleDummyResult::value) lies within
+  // [lower, upper], both are equal to it unless any of the needed searches
+  // reached the node limit
+  int16_t lower;
+  int16_t upper;
+};
+
+// all double dummy outcomes of a single deal (see
+// TarokGame::NewInitialTarokState()), entries are ordered by declarer,
+// contract and called king
+struct DoubleDummyTable {
+  int64_t deal_index;
+  std::vector<DoubleDummyTableEntry> entries;
+};
+
+// solves every contract that each player can declare by bidding it while all
+// other players pass, in four player contracts with king calling every king
+// that can be called is solved separately, the declarer chooses the talon set
+// with the best solved value while discarding is left to a fixed heuristic
+// (cards worth the least points first, preferring cards from the shortest
+// suit) since solving every combination of discarded cards would multiply the
+// already long solving times, such entries are marked with
+// heuristic_discards
+//
+// whether the declarer wins is solved first as it takes a single null window
+// search that usually finishes within the node limit even from the first
+// trick on, the return is solved afterwards, each solve visits at most
+// max_nodes positions (0 means no limit) after which only the bounds proven so
+// far are kept, note that returns of positive contracts are usually only
+// bounded from the first trick on since ultimo and other bonuses widen the
+// range of values to search, entries of each deal and declarer are solved by a
+// separate task of the pool that shares a single solver between them
+std::vector<DoubleDummyTable> DoubleDummyTables(const TarokGame& game,
+                                                int64_t first_deal_index,
+                                                int num_deals,
+                                                int64_t max_nodes,
+                                                ThreadPool* pool);
+
+// tables are stored as 8 bytes of the deal index, 1 byte of the number of
+// entries and 10 bytes per entry (contract, declarer, called king, talon set,
+// won, heuristic discards, 2 bytes of the lower bound and 2 bytes of the upper
+// bound), all in little endian byte order
+void WriteDoubleDummyTable(const DoubleDummyTable& table, std::ostream* out);
+// returns false if there are no more tables in the stream
+bool ReadDoubleDummyTable(std::istream* in, DoubleDummyTable* table);
+
+}  // namespace tarok
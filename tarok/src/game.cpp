@@ -9,13 +9,18 @@ namespace tarok {
 TarokGame::TarokGame(const open_spiel::GameParameters& params)
     : Game(kGameType, params),
       num_players_(ParameterValue<int>("num_players")),
-      rng_(std::mt19937(ParameterValue<int>("seed") == -1
-                            ? std::time(0)
-                            : ParameterValue<int>("seed"))) {
+      seed_(ParameterValue<int>("seed") == -1 ? std::time(0)
+                                               : ParameterValue<int>("seed")) {
   SPIEL_CHECK_GE(num_players_, kGameType.min_num_players);
   SPIEL_CHECK_LE(num_players_, kGameType.max_num_players);
 }
 
+TarokGame::TarokGame(const TarokGame& game)
+    : Game(game),
+      num_players_(game.num_players_),
+      seed_(game.seed_),
+      num_deals_(game.num_deals_.load()) {}
+
 int TarokGame::NumDistinctActions() const { return 54; }
 
 std::unique_ptr<open_spiel::State> TarokGame::NewInitialState() const {
@@ -23,7 +28,13 @@ std::unique_ptr<open_spiel::State> TarokGame::NewInitialState() const {
 }
 
 std::unique_ptr<TarokState> TarokGame::NewInitialTarokState() const {
-  return std::make_unique<TarokState>(shared_from_this());
+  return NewInitialTarokState(num_deals_++);
+}
+
+std::unique_ptr<TarokState> TarokGame::NewInitialTarokState(
+    int64_t deal_index) const {
+  return std::make_unique<TarokState>(shared_from_this(),
+                                      DealSeed(deal_index));
 }
 
 int TarokGame::MaxChanceOutcomes() const {
@@ -53,7 +64,25 @@ int TarokGame::MaxGameLength() const {
   }
 }
 
-int TarokGame::RNG() const { return rng_(); }
+std::vector<int> TarokGame::InformationStateTensorShape() const {
+  // see TarokState::InformationStateTensor() for the layout
+  int num_tricks = 48 / num_players_;
+  return {num_players_ + 54 + num_players_ * 13 + 4 + 3 * 54 +
+          num_tricks * (num_players_ + num_players_ * 54)};
+}
+
+std::vector<int> TarokGame::ObservationTensorShape() const {
+  // see TarokState::ObservationTensor() for the layout
+  return {54 + num_players_ * 13 + 12 + num_players_ + 1 + num_players_ +
+          2 * num_players_ * 54 + num_players_};
+}
+
+int TarokGame::DealSeed(int64_t deal_index) const {
+  // a Weyl sequence over the deal indices, mt19937 seeding takes care of
+  // decorrelating nearby seeds
+  return static_cast<uint32_t>(seed_) +
+         static_cast<uint32_t>(deal_index) * 0x9E3779B9u;
+}
 
 std::shared_ptr<const TarokGame> NewTarokGame(
     const open_spiel::GameParameters& params) {
@@ -3,6 +3,7 @@
 #pragma once
 
 #include <array>
+#include <atomic>
 #include <memory>
 
 #include "open_spiel/spiel.h"
@@ -28,9 +29,9 @@ static inline const open_spiel::GameType kGameType{
     4,      // max_num_players
     3,      // min_num_players
     true,   // provides_information_state_string
-    false,  // provides_information_state_tensor
+    true,   // provides_information_state_tensor
     false,  // provides_observation_string
-    false,  // provides_observation_tensor
+    true,   // provides_observation_tensor
     // parameter_specification
     {{"num_players", open_spiel::GameParameter(kDefaultNumPLayers)},
      {"seed", open_spiel::GameParameter(kDefaultSeed)}}};
@@ -38,32 +39,43 @@ static inline const open_spiel::GameType kGameType{
 class TarokGame : public open_spiel::Game {
  public:
   explicit TarokGame(const open_spiel::GameParameters& params);
+  TarokGame(const TarokGame& game);
 
   int NumDistinctActions() const override;
   std::unique_ptr<open_spiel::State> NewInitialState() const override;
+  // subsequent states are dealt subsequent deals, i.e. the n-th state
+  // created by this game instance deals the cards of the deal with index n
   std::unique_ptr<TarokState> NewInitialTarokState() const;
+  // deals are reproducible from their index and the game seed alone so the
+  // same deal can be replayed regardless of how many states were created
+  // before, e.g. by different threads sharing this game instance
+  std::unique_ptr<TarokState> NewInitialTarokState(int64_t deal_index) const;
   int MaxChanceOutcomes() const override;
   int NumPlayers() const override;
   double MinUtility() const override;
   double MaxUtility() const override;
   std::shared_ptr<const Game> Clone() const override;
   int MaxGameLength() const override;
+  std::vector<int> InformationStateTensorShape() const override;
+  std::vector<int> ObservationTensorShape() const override;
 
  private:
   friend class TarokState;
-  // this function is const so that it can be called from state objects,
-  // note that it nevertheless changes the state of the mutable rng_ used
-  // for shuffling the cards, this is expected behaviour since the game
-  // object has to maintain an internal RNG state due to implicit stochasticity,
-  // see ChanceOutcomes() comments in open_spiel/spiel.h for more info
-  int RNG() const;
+  friend class TarokVectorEnv;
+  // mixes the game seed with the deal index, the result seeds the RNG of a
+  // single state which makes dealing independent of all other states and
+  // thus safe to do from multiple threads, note that the deal with index 0
+  // is seeded with the game seed itself
+  int DealSeed(int64_t deal_index) const;
 
-  static inline const std::array<Card, 54> card_deck_ = InitializeCardDeck();
   static inline const std::array<Contract, 12> contracts_ =
       InitializeContracts();
 
   const int num_players_;
-  mutable std::mt19937 rng_;
+  const int seed_;
+  // the only mutable state of the game instance, the counter is atomic so
+  // that states can be created from multiple threads without locking
+  mutable std::atomic<int64_t> num_deals_ = 0;
 };
 
 // instantiate the game instance via a shared_ptr, see game declaration
@@ -0,0 +1,239 @@
+/* Copyright 2020 Semantic Weights. All rights reserved. */
+
+#include "src/ismcts.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+
+namespace tarok {
+
+IsmctsBot::Node::Node(open_spiel::Action action, open_spiel::Player player)
+    : action(action), player(player) {}
+
+IsmctsBot::IsmctsBot(const IsmctsConfig& config) : config_(config) {
+  SPIEL_CHECK_GE(config_.num_iterations, 0);
+  SPIEL_CHECK_GE(config_.max_seconds, 0);
+  SPIEL_CHECK_TRUE(config_.num_iterations > 0 || config_.max_seconds > 0);
+  SPIEL_CHECK_GE(config_.num_threads, 1);
+  if (config_.num_threads > 1)
+    pool_ = std::make_unique<ThreadPool>(config_.num_threads);
+}
+
+open_spiel::Action IsmctsBot::Step(const TarokState& state) {
+  SPIEL_CHECK_GE(state.CurrentPlayer(), 0);
+  PrepareRoots(state);
+  num_started_iterations_ = 0;
+  num_iterations_ = 0;
+  ActionBitmask legal_actions = state.LegalActionsBitmask();
+  // there's nothing to search with a single legal action
+  if ((legal_actions & (legal_actions - 1)) == 0)
+    return __builtin_ctzll(legal_actions);
+
+  DeterminizationSampler sampler(state, player_);
+  deadline_ = std::chrono::steady_clock::now() +
+              std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                  std::chrono::duration<double>(config_.max_seconds));
+  if (pool_) {
+    for (int i = 0; i < config_.num_threads; i++)
+      pool_->Submit([this, i, &sampler]() { RunWorker(i, sampler); });
+    pool_->Wait();
+  } else {
+    RunWorker(0, sampler);
+  }
+  num_searches_++;
+
+  // ties are broken in favour of the lowest action
+  open_spiel::Action best_action = open_spiel::kInvalidAction;
+  int best_visits = -1;
+  for (auto const& [action, visits] : RootVisitCounts()) {
+    if (visits > best_visits) {
+      best_action = action;
+      best_visits = visits;
+    }
+  }
+  return best_action;
+}
+
+void IsmctsBot::PrepareRoots(const TarokState& state) {
+  // trees can only be reused if the state continues the game of the previous
+  // search, i.e. it is the same deal of the same game with the previously
+  // searched actions at the start of its history
+  const auto& history = state.FullHistory();
+  bool reuse_roots =
+      config_.reuse_tree && !roots_.empty() &&
+      state.GetGame().get() == game_ &&
+      state.DealSeed() == deal_seed_ && state.CurrentPlayer() == player_ &&
+      history.size() >= root_history_.size() &&
+      std::equal(root_history_.begin(), root_history_.end(), history.begin(),
+                 [](open_spiel::Action action,
+                    const open_spiel::PlayerAction& player_action) {
+                   return action == player_action.action;
+                 });
+
+  int num_trees = config_.parallelism == IsmctsParallelism::kRoot
+                      ? config_.num_threads
+                      : 1;
+  if (!reuse_roots) roots_.clear();
+  roots_.resize(num_trees);
+  for (auto& root : roots_) {
+    if (root) {
+      // the subtree of the taken actions is kept while the rest of the tree
+      // is freed
+      for (size_t i = root_history_.size(); i < history.size() && root; i++) {
+        auto child = std::find_if(
+            root->children.begin(), root->children.end(),
+            [&](const std::unique_ptr<Node>& node) {
+              return node->action == history.at(i).action;
+            });
+        if (child == root->children.end()) {
+          root.reset();
+        } else {
+          std::unique_ptr<Node> node = std::move(*child);
+          root = std::move(node);
+        }
+      }
+    }
+    if (!root) {
+      root = std::make_unique<Node>(open_spiel::kInvalidAction,
+                                    open_spiel::kInvalidPlayer);
+    }
+  }
+
+  game_ = state.GetGame().get();
+  deal_seed_ = state.DealSeed();
+  player_ = state.CurrentPlayer();
+  root_history_.clear();
+  for (auto const& player_action : history)
+    root_history_.push_back(player_action.action);
+}
+
+void IsmctsBot::RunWorker(int worker_index,
+                          const DeterminizationSampler& sampler) {
+  std::seed_seq seed{config_.seed, num_searches_, worker_index};
+  std::mt19937 rng(seed);
+  Node* root = roots_.at(roots_.size() == 1 ? 0 : worker_index).get();
+  auto state = sampler.Sample(&rng);
+  std::vector<Node*> path;
+  while (true) {
+    if (config_.num_iterations > 0 &&
+        num_started_iterations_++ >= config_.num_iterations) {
+      break;
+    }
+    if (config_.max_seconds > 0 &&
+        std::chrono::steady_clock::now() >= deadline_) {
+      break;
+    }
+    sampler.Resample(&rng, state.get());
+    RunIteration(root, state.get(), &rng, &path);
+    num_iterations_++;
+  }
+}
+
+void IsmctsBot::RunIteration(Node* root, TarokState* state, std::mt19937* rng,
+                             std::vector<Node*>* path) {
+  size_t root_history_size = state->FullHistory().size();
+  path->clear();
+  path->push_back(root);
+  bool expanded = false;
+  while (!state->IsTerminal() && !expanded) {
+    Node* child = SelectChild(path->back(), *state, rng, &expanded);
+    state->ApplyTrustedAction(child->action);
+    path->push_back(child);
+  }
+  while (!state->IsTerminal())
+    state->ApplyTrustedAction(RandomAction(state->LegalActionsBitmask(), rng));
+
+  std::vector<double> returns = state->Returns();
+  bool uses_virtual_loss = config_.parallelism == IsmctsParallelism::kTree &&
+                           config_.num_threads > 1;
+  for (int i = path->size() - 1; i > 0; i--) {
+    Node* node = path->at(i);
+    std::lock_guard<std::mutex> lock(path->at(i - 1)->mutex);
+    node->visits++;
+    node->total_return += returns.at(node->player);
+    if (uses_virtual_loss) node->virtual_losses--;
+  }
+  {
+    std::lock_guard<std::mutex> lock(root->mutex);
+    root->visits++;
+  }
+
+  while (state->FullHistory().size() > root_history_size) {
+    open_spiel::PlayerAction last = state->FullHistory().back();
+    state->UndoAction(last.player, last.action);
+  }
+}
+
+IsmctsBot::Node* IsmctsBot::SelectChild(Node* node, const TarokState& state,
+                                        std::mt19937* rng, bool* expanded) {
+  ActionBitmask legal_actions = state.LegalActionsBitmask();
+  std::lock_guard<std::mutex> lock(node->mutex);
+  Node* selected_child = nullptr;
+  ActionBitmask untried_actions = legal_actions & ~node->children_actions;
+  if (untried_actions != 0) {
+    open_spiel::Action action = RandomAction(untried_actions, rng);
+    node->children.push_back(
+        std::make_unique<Node>(action, state.CurrentPlayer()));
+    node->children_actions |= ActionBitmask{1} << action;
+    selected_child = node->children.back().get();
+    *expanded = true;
+  }
+
+  double best_value = -std::numeric_limits<double>::infinity();
+  for (auto const& child : node->children) {
+    if (!(legal_actions & (ActionBitmask{1} << child->action))) continue;
+    child->availability++;
+    if (*expanded) continue;
+    double value = UcbValue(*child);
+    if (value > best_value) {
+      best_value = value;
+      selected_child = child.get();
+    }
+  }
+  if (config_.parallelism == IsmctsParallelism::kTree &&
+      config_.num_threads > 1) {
+    selected_child->virtual_losses++;
+  }
+  return selected_child;
+}
+
+double IsmctsBot::UcbValue(const Node& child) const {
+  // children that were just created by other threads are visited first
+  int visits = child.visits + child.virtual_losses;
+  if (visits == 0) return std::numeric_limits<double>::infinity();
+  double mean_return =
+      (child.total_return - child.virtual_losses * config_.virtual_loss) /
+      visits;
+  return mean_return +
+         config_.uct_c * std::sqrt(std::log(child.availability) / visits);
+}
+
+std::vector<std::pair<open_spiel::Action, int>> IsmctsBot::RootVisitCounts()
+    const {
+  std::array<int, 54> visits{};
+  ActionBitmask actions = 0;
+  for (auto const& root : roots_) {
+    for (auto const& child : root->children) {
+      visits.at(child->action) += child->visits;
+      actions |= ActionBitmask{1} << child->action;
+    }
+  }
+  std::vector<std::pair<open_spiel::Action, int>> visit_counts;
+  for (; actions != 0; actions &= actions - 1) {
+    open_spiel::Action action = __builtin_ctzll(actions);
+    visit_counts.push_back({action, visits.at(action)});
+  }
+  return visit_counts;
+}
+
+int64_t IsmctsBot::NumIterations() const { return num_iterations_; }
+
+void IsmctsBot::Reset() {
+  roots_.clear();
+  root_history_.clear();
+  player_ = open_spiel::kInvalidPlayer;
+}
+
+}  // namespace tarok
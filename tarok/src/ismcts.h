@@ -0,0 +1,129 @@
+/* Copyright 2020 Semantic Weights. All rights reserved. */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "open_spiel/spiel.h"
+#include "src/determinization_sampler.h"
+#include "src/state.h"
+#include "src/thread_pool.h"
+
+namespace tarok {
+
+enum class IsmctsParallelism : int8_t {
+  // each thread searches its own tree and visit counts of root actions are
+  // summed up over all trees
+  kRoot,
+  // all threads search the same tree, virtual losses steer threads that
+  // descend at the same time into different branches
+  kTree
+};
+
+struct IsmctsConfig {
+  // iterations per search, 0 means no limit
+  int64_t num_iterations = 10000;
+  // wall time per search in seconds, 0 means no limit, at least one of the
+  // limits has to be set
+  double max_seconds = 0;
+  int num_threads = 1;
+  IsmctsParallelism parallelism = IsmctsParallelism::kTree;
+  // exploration constant of UCB, in points since node values are players'
+  // returns
+  double uct_c = 50;
+  // return (in negative points) counted for every iteration that is still
+  // descending through a node when searching with tree parallelism
+  double virtual_loss = 50;
+  // whether the subtree of the actions taken since the previous search is
+  // kept as long as the searched states belong to the same game and player
+  bool reuse_tree = true;
+  int seed = 0;
+};
+
+// single observer information set Monte Carlo tree search, i.e. a single tree
+// is built from the point of view of the searching player where every
+// iteration first samples cards that are hidden from the player (see
+// DeterminizationSampler) and then descends the tree along the actions that
+// are legal in the sampled state, nodes correspond to sequences of actions
+// rather than states so the statistics of a node are shared by all sampled
+// states in which its actions were taken, actions are selected by UCB where
+// the number of parent visits is replaced by the number of times the action
+// was legal (its availability) and new nodes are evaluated by a single random
+// rollout
+//
+// sampled states are undone back to the searched state after each iteration
+// and resampled in place so that iterations don't allocate anything but new
+// nodes
+class IsmctsBot {
+ public:
+  explicit IsmctsBot(const IsmctsConfig& config);
+
+  // searches the state of the current player and returns the most visited
+  // action, the current player mustn't be chance
+  open_spiel::Action Step(const TarokState& state);
+  // visit counts of the root actions after the last search, summed up over
+  // all trees with root parallelism
+  std::vector<std::pair<open_spiel::Action, int>> RootVisitCounts() const;
+  // number of iterations of the last search
+  int64_t NumIterations() const;
+  // drops the trees so that the next search starts from scratch
+  void Reset();
+
+ private:
+  struct Node {
+    Node(open_spiel::Action action, open_spiel::Player player);
+
+    // the action leading to the node and the player who took it, node values
+    // are this player's returns
+    const open_spiel::Action action;
+    const open_spiel::Player player;
+    int visits = 0;
+    int availability = 0;
+    // iterations that are descending through the node in other threads
+    int virtual_losses = 0;
+    double total_return = 0;
+    ActionBitmask children_actions = 0;
+    std::vector<std::unique_ptr<Node>> children;
+    // guards the children and their statistics (or the root's own statistics)
+    // with tree parallelism
+    std::mutex mutex;
+  };
+
+  // moves the roots to the nodes of the actions that were taken since the
+  // previous search or starts new trees if the state doesn't follow it
+  void PrepareRoots(const TarokState& state);
+  void RunWorker(int worker_index, const DeterminizationSampler& sampler);
+  // descends from the root, expands a single node and evaluates it by a
+  // rollout, the state is undone back to the root afterwards
+  void RunIteration(Node* root, TarokState* state, std::mt19937* rng,
+                    std::vector<Node*>* path);
+  // selects the child to descend to among the legal actions, a new child is
+  // created if any of the legal actions wasn't tried yet
+  Node* SelectChild(Node* node, const TarokState& state, std::mt19937* rng,
+                    bool* expanded);
+  double UcbValue(const Node& child) const;
+
+  const IsmctsConfig config_;
+  std::unique_ptr<ThreadPool> pool_;
+  // a single tree with tree parallelism, one tree per thread otherwise
+  std::vector<std::unique_ptr<Node>> roots_;
+  // identifies the game round of the roots, see PrepareRoots()
+  const open_spiel::Game* game_ = nullptr;
+  int deal_seed_ = 0;
+  open_spiel::Player player_ = open_spiel::kInvalidPlayer;
+  std::vector<open_spiel::Action> root_history_;
+  int num_searches_ = 0;
+  // shared by the workers of a single search
+  std::atomic<int64_t> num_started_iterations_ = 0;
+  std::atomic<int64_t> num_iterations_ = 0;
+  std::chrono::steady_clock::time_point deadline_;
+};
+
+}  // namespace tarok
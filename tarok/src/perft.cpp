@@ -0,0 +1,99 @@
+/* Copyright 2020 Semantic Weights. All rights reserved. */
+
+#include "src/perft.h"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace tarok {
+
+int64_t PerftCounts::Nodes(int depth) const {
+  int64_t num_nodes = 0;
+  for (auto const& phase_nodes : nodes.at(depth)) num_nodes += phase_nodes;
+  return num_nodes;
+}
+
+int64_t PerftCounts::Nodes(int depth, GamePhase game_phase) const {
+  return nodes.at(depth).at(static_cast<int>(game_phase));
+}
+
+int64_t PerftCounts::TotalNodes() const {
+  int64_t num_nodes = 0;
+  for (size_t depth = 0; depth < nodes.size(); depth++) {
+    num_nodes += Nodes(depth);
+  }
+  return num_nodes;
+}
+
+void PerftCounts::Add(const PerftCounts& counts) {
+  if (nodes.size() < counts.nodes.size()) nodes.resize(counts.nodes.size());
+  for (size_t depth = 0; depth < counts.nodes.size(); depth++) {
+    for (size_t phase = 0; phase < nodes.at(depth).size(); phase++) {
+      nodes.at(depth).at(phase) += counts.nodes.at(depth).at(phase);
+    }
+  }
+}
+
+static void PerftRecursive(TarokState* state, int depth, int max_depth,
+                           GamePhase last_game_phase, PerftCounts* counts) {
+  GamePhase game_phase = state->CurrentGamePhase();
+  counts->nodes[depth][static_cast<int>(game_phase)]++;
+  if (depth == max_depth || state->IsTerminal() ||
+      game_phase > last_game_phase) {
+    return;
+  }
+
+  open_spiel::Player player = state->CurrentPlayer();
+  for (ActionBitmask actions = state->LegalActionsBitmask(); actions != 0;
+       actions &= actions - 1) {
+    open_spiel::Action action = LowestCardAction(actions);
+    state->ApplyTrustedAction(action);
+    PerftRecursive(state, depth + 1, max_depth, last_game_phase, counts);
+    state->UndoAction(player, action);
+  }
+}
+
+PerftCounts Perft(const TarokState& state, int depth,
+                  GamePhase last_game_phase) {
+  SPIEL_CHECK_GE(depth, 0);
+  PerftCounts counts;
+  counts.nodes.resize(depth + 1);
+  auto clone = state.Clone();
+  PerftRecursive(static_cast<TarokState*>(clone.get()), 0, depth,
+                 last_game_phase, &counts);
+  return counts;
+}
+
+PerftCounts ParallelPerft(const TarokGame& game, int64_t first_deal_index,
+                          int num_deals, int depth, GamePhase last_game_phase,
+                          int num_threads) {
+  SPIEL_CHECK_GE(num_threads, 1);
+  std::atomic<int64_t> next_deal_index = first_deal_index;
+  std::vector<PerftCounts> threads_counts(num_threads);
+  std::vector<std::thread> threads;
+  threads.reserve(num_threads);
+  for (int i = 0; i < num_threads; i++) {
+    threads.emplace_back([&, i]() {
+      // deals are taken one by one since tree sizes vary a lot between deals
+      for (int64_t deal_index = next_deal_index++;
+           deal_index < first_deal_index + num_deals;
+           deal_index = next_deal_index++) {
+        auto state = game.NewInitialTarokState(deal_index);
+        state->ApplyTrustedAction(0);
+        threads_counts.at(i).Add(Perft(*state, depth, last_game_phase));
+      }
+    });
+  }
+
+  PerftCounts counts;
+  counts.nodes.resize(depth + 1);
+  for (int i = 0; i < num_threads; i++) {
+    threads.at(i).join();
+    counts.Add(threads_counts.at(i));
+  }
+  return counts;
+}
+
+}  // namespace tarok
@@ -0,0 +1,43 @@
+/* Copyright 2020 Semantic Weights. All rights reserved. */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "src/game.h"
+#include "src/state.h"
+
+namespace tarok {
+
+// numbers of nodes in a game tree, nodes are grouped by their depth relative
+// to the root and by the game phase of the node, i.e. nodes.at(depth).at(phase)
+struct PerftCounts {
+  int64_t Nodes(int depth) const;
+  int64_t Nodes(int depth, GamePhase game_phase) const;
+  int64_t TotalNodes() const;
+  void Add(const PerftCounts& counts);
+
+  std::vector<std::array<int64_t, 6>> nodes;
+};
+
+// counts all nodes up to the given depth below the state (the state itself is
+// counted at depth 0), nodes in game phases after the given last game phase
+// are counted but not expanded which e.g. allows enumerating the whole
+// bidding, king calling and talon exchange tree by passing
+// GamePhase::kTalonExchange, the tree is traversed by applying and undoing
+// trusted actions on a single clone of the state so it doubles as a
+// throughput benchmark of the legal actions generation and as a correctness
+// oracle for any other way of generating and applying actions
+PerftCounts Perft(const TarokState& state, int depth,
+                  GamePhase last_game_phase = GamePhase::kFinished);
+
+// runs Perft() from the dealt initial states of the given number of
+// consecutive deals (see TarokGame::NewInitialTarokState()), deals are
+// distributed among the given number of threads and the counts are summed up
+PerftCounts ParallelPerft(const TarokGame& game, int64_t first_deal_index,
+                          int num_deals, int depth, GamePhase last_game_phase,
+                          int num_threads);
+
+}  // namespace tarok
@@ -1,15 +1,45 @@
 /* Copyright 2020 Semantic Weights. All rights reserved. */
 
+#include <algorithm>
 #include <memory>
+#include <vector>
 
+#include "pybind11/numpy.h"
 #include "pybind11/pybind11.h"
 #include "pybind11/stl.h"
 #include "src/game.h"
+#include "src/ismcts.h"
+#include "src/random_games.h"
+#include "src/vector_env.h"
 
 namespace tarok {
 
 namespace py = pybind11;
 
+// copies a flat buffer of values of consecutive games to an array with a row
+// per game
+template <typename ArrayType, typename ValueType>
+static py::array_t<ArrayType> ToArray(const std::vector<ValueType>& values,
+                                      int num_games) {
+  std::vector<py::ssize_t> shape{num_games};
+  if (values.size() > static_cast<size_t>(num_games))
+    shape.push_back(values.size() / num_games);
+  py::array_t<ArrayType> array(shape);
+  std::copy(values.begin(), values.end(), array.mutable_data());
+  return array;
+}
+
+// current players, legal actions masks, rewards, dones and info state tensors
+static py::tuple VectorEnvOutputs(const TarokVectorEnv& env) {
+  int num_envs = env.NumEnvs();
+  return py::make_tuple(
+      ToArray<int>(env.CurrentPlayers(), num_envs),
+      ToArray<bool>(env.LegalActionsMasks(), num_envs),
+      ToArray<double>(env.Rewards(), num_envs),
+      ToArray<bool>(env.Dones(), num_envs),
+      ToArray<float>(env.InformationStateTensors(), num_envs));
+}
+
 PYBIND11_MODULE(pytarok, m) {
   py::module::import("pyspiel");
 
@@ -25,6 +55,7 @@ PYBIND11_MODULE(pytarok, m) {
 
   // state object
   py::class_<TarokState, open_spiel::State> tarok_state(m, "TarokState");
+  tarok_state.def("apply_trusted_action", &TarokState::ApplyTrustedAction);
   tarok_state.def("card_action_to_string", &TarokState::CardActionToString);
   tarok_state.def("current_game_phase", &TarokState::CurrentGamePhase);
   tarok_state.def("player_cards", &TarokState::PlayerCards);
@@ -32,6 +63,11 @@ PYBIND11_MODULE(pytarok, m) {
   tarok_state.def("talon", &TarokState::Talon);
   tarok_state.def("talon_sets", &TarokState::TalonSets);
   tarok_state.def("trick_cards", &TarokState::TrickCards);
+  tarok_state.def("hash", &TarokState::Hash);
+  tarok_state.def("information_state_key", &TarokState::InformationStateKey);
+  // states are hashable and comparable by position, e.g. for deduplication
+  tarok_state.def("__hash__", &TarokState::Hash);
+  tarok_state.def("__eq__", &TarokState::operator==, py::is_operator());
   tarok_state.def("captured_mond_penalties",
                   &TarokState::CapturedMondPenalties);
   tarok_state.def("scores_without_captured_mond_penalties",
@@ -61,6 +97,95 @@ PYBIND11_MODULE(pytarok, m) {
   contract.value("COLOUR_VALAT_WITHOUT", ContractName::kColourValatWithout);
   contract.value("VALAT_WITHOUT", ContractName::kValatWithout);
   contract.value("NOT_SELECTED", ContractName::kNotSelected);
+
+  // information set Monte Carlo tree search objects
+  py::enum_<IsmctsParallelism> ismcts_parallelism(m, "IsmctsParallelism");
+  ismcts_parallelism.value("ROOT", IsmctsParallelism::kRoot);
+  ismcts_parallelism.value("TREE", IsmctsParallelism::kTree);
+
+  py::class_<IsmctsConfig> ismcts_config(m, "IsmctsConfig");
+  ismcts_config.def(py::init<>());
+  ismcts_config.def_readwrite("num_iterations", &IsmctsConfig::num_iterations);
+  ismcts_config.def_readwrite("max_seconds", &IsmctsConfig::max_seconds);
+  ismcts_config.def_readwrite("num_threads", &IsmctsConfig::num_threads);
+  ismcts_config.def_readwrite("parallelism", &IsmctsConfig::parallelism);
+  ismcts_config.def_readwrite("uct_c", &IsmctsConfig::uct_c);
+  ismcts_config.def_readwrite("virtual_loss", &IsmctsConfig::virtual_loss);
+  ismcts_config.def_readwrite("reuse_tree", &IsmctsConfig::reuse_tree);
+  ismcts_config.def_readwrite("seed", &IsmctsConfig::seed);
+
+  py::class_<IsmctsBot> ismcts_bot(m, "IsmctsBot");
+  ismcts_bot.def(py::init<const IsmctsConfig&>());
+  // searches run without the GIL so that other python threads can progress
+  ismcts_bot.def("step", &IsmctsBot::Step,
+                 py::call_guard<py::gil_scoped_release>());
+  ismcts_bot.def("root_visit_counts", &IsmctsBot::RootVisitCounts);
+  ismcts_bot.def("num_iterations", &IsmctsBot::NumIterations);
+  ismcts_bot.def("reset", &IsmctsBot::Reset);
+
+  // vectorized environment object, all games are stepped by a single call
+  // without the GIL and outputs are returned as numpy arrays
+  py::class_<TarokVectorEnv> vector_env(m, "TarokVectorEnv");
+  vector_env.def(
+      py::init([](std::shared_ptr<TarokGame> game, int num_envs) {
+        return std::make_unique<TarokVectorEnv>(game, num_envs);
+      }));
+  vector_env.def("reset", [](TarokVectorEnv& env) {
+    {
+      py::gil_scoped_release release;
+      env.Reset();
+    }
+    return VectorEnvOutputs(env);
+  });
+  vector_env.def(
+      "step",
+      [](TarokVectorEnv& env,
+         py::array_t<open_spiel::Action,
+                     py::array::c_style | py::array::forcecast>
+             actions) {
+        SPIEL_CHECK_EQ(actions.ndim(), 1);
+        absl::Span<const open_spiel::Action> actions_span(actions.data(),
+                                                          actions.size());
+        {
+          py::gil_scoped_release release;
+          env.Step(actions_span);
+        }
+        return VectorEnvOutputs(env);
+      });
+  vector_env.def("num_envs", &TarokVectorEnv::NumEnvs);
+  vector_env.def("state", &TarokVectorEnv::State,
+                 py::return_value_policy::reference_internal);
+
+  // random games are played without the GIL and returned as a dict of numpy
+  // arrays with a row per game
+  m.def(
+      "play_random_games",
+      [](int num_games, int seed, int num_threads, int num_players,
+         bool record_histories) {
+        RandomGamesResult result;
+        {
+          py::gil_scoped_release release;
+          result = PlayRandomGames(num_games, seed, num_threads, num_players,
+                                   record_histories);
+        }
+        py::array_t<int8_t> contracts(num_games);
+        for (int i = 0; i < num_games; i++) {
+          contracts.mutable_at(i) =
+              static_cast<int8_t>(result.contracts.at(i));
+        }
+        py::dict arrays;
+        arrays["contracts"] = contracts;
+        arrays["returns"] = ToArray<double>(result.returns, num_games);
+        arrays["game_lengths"] = ToArray<int>(result.game_lengths, num_games);
+        if (record_histories) {
+          arrays["histories"] =
+              ToArray<open_spiel::Action>(result.histories, num_games);
+        }
+        return arrays;
+      },
+      py::arg("num_games"), py::arg("seed"), py::arg("num_threads") = 1,
+      py::arg("num_players") = kDefaultNumPLayers,
+      py::arg("record_histories") = false);
 }
 
 }  // namespace tarok
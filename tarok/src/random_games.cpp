@@ -0,0 +1,87 @@
+/* Copyright 2020 Semantic Weights. All rights reserved. */
+
+#include "src/random_games.h"
+
+#include <algorithm>
+#include <ctime>
+#include <memory>
+#include <random>
+
+#include "src/game.h"
+#include "src/thread_pool.h"
+
+namespace tarok {
+
+// large enough to amortize seeding the generator and scheduling the task
+static constexpr int kGamesPerChunk = 256;
+
+static void PlayRandomGamesChunk(const TarokGame& game, int seed, int chunk,
+                                 bool record_histories,
+                                 RandomGamesResult* result) {
+  std::seed_seq seed_seq{seed, chunk};
+  std::mt19937 rng(seed_seq);
+  int first_game = chunk * kGamesPerChunk;
+  int last_game = std::min(first_game + kGamesPerChunk, result->num_games);
+  for (int i = first_game; i < last_game; i++) {
+    auto state = game.NewInitialTarokState(i);
+    state->ApplyTrustedAction(0);
+    while (!state->IsTerminal()) {
+      state->ApplyTrustedAction(
+          RandomAction(state->LegalActionsBitmask(), &rng));
+    }
+
+    result->contracts[i] = state->SelectedContractName();
+    std::vector<double> returns = state->Returns();
+    std::copy(returns.begin(), returns.end(),
+              result->returns.begin() + i * result->num_players);
+    const auto& history = state->FullHistory();
+    result->game_lengths[i] = history.size() - 1;
+    if (record_histories) {
+      auto game_history =
+          result->histories.begin() + i * result->max_game_length;
+      for (size_t j = 1; j < history.size(); j++)
+        game_history[j - 1] = history[j].action;
+    }
+  }
+}
+
+RandomGamesResult PlayRandomGames(int num_games, int seed, int num_threads,
+                                  int num_players, bool record_histories) {
+  SPIEL_CHECK_GE(num_games, 0);
+  SPIEL_CHECK_GE(num_threads, 1);
+  // the clock seed is resolved here rather than by the game so that the
+  // chunks' generators are seeded by the same seed as the deals
+  if (seed == -1) seed = std::time(0);
+  auto game = NewTarokGame(open_spiel::GameParameters(
+      {{"num_players", open_spiel::GameParameter(num_players)},
+       {"seed", open_spiel::GameParameter(seed)}}));
+  RandomGamesResult result;
+  result.num_games = num_games;
+  result.num_players = num_players;
+  result.max_game_length = game->MaxGameLength();
+  // every game writes to its own part of the preallocated buffers
+  result.contracts.resize(num_games, ContractName::kNotSelected);
+  result.returns.resize(num_games * num_players);
+  result.game_lengths.resize(num_games);
+  if (record_histories) {
+    result.histories.resize(num_games * result.max_game_length,
+                            open_spiel::kInvalidAction);
+  }
+
+  int num_chunks = (num_games + kGamesPerChunk - 1) / kGamesPerChunk;
+  if (num_threads == 1) {
+    for (int i = 0; i < num_chunks; i++)
+      PlayRandomGamesChunk(*game, seed, i, record_histories, &result);
+  } else {
+    ThreadPool pool(num_threads);
+    for (int i = 0; i < num_chunks; i++) {
+      pool.Submit([&game, seed, i, record_histories, &result]() {
+        PlayRandomGamesChunk(*game, seed, i, record_histories, &result);
+      });
+    }
+    pool.Wait();
+  }
+  return result;
+}
+
+}  // namespace tarok
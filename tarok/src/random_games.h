@@ -0,0 +1,39 @@
+/* Copyright 2020 Semantic Weights. All rights reserved. */
+
+#pragma once
+
+#include <vector>
+
+#include "open_spiel/spiel.h"
+#include "src/contracts.h"
+
+namespace tarok {
+
+// outcomes of games played by PlayRandomGames(), values of each game are at
+// the game's index times the size of a single game's values
+struct RandomGamesResult {
+  int num_games;
+  int num_players;
+  // TarokGame::MaxGameLength() values per game in histories
+  int max_game_length;
+  std::vector<ContractName> contracts;
+  // NumPlayers() values per game
+  std::vector<double> returns;
+  // number of players' actions, i.e. without the card dealing action
+  std::vector<int> game_lengths;
+  // players' actions of each game padded with open_spiel::kInvalidAction,
+  // empty unless the histories were requested
+  std::vector<open_spiel::Action> histories;
+};
+
+// plays games where every player takes uniformly random legal actions, the
+// game with index i is dealt the deal with index i of a game with the given
+// seed (see TarokGame::NewInitialTarokState()) and games are played in
+// chunks of consecutive games with a random number generator seeded by the
+// seed and the chunk's index, so results don't depend on the number of
+// threads, a seed of -1 is replaced by one from the clock
+RandomGamesResult PlayRandomGames(int num_games, int seed, int num_threads,
+                                  int num_players,
+                                  bool record_histories = false);
+
+}  // namespace tarok
@@ -3,124 +3,303 @@
 #include "src/state.h"
 
 #include <algorithm>
+#include <array>
 #include <cmath>
+#include <random>
 
 #include "src/game.h"
+#include "src/tricks.h"
 
 namespace tarok {
 
+static constexpr ActionBitmask ActionToBitmask(open_spiel::Action action) {
+  return ActionBitmask{1} << action;
+}
+
+static constexpr uint8_t kAllTalonPositions = (1 << 6) - 1;
+
+static constexpr uint64_t SplitMix64(uint64_t value) {
+  value += 0x9e3779b97f4a7c15;
+  value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9;
+  value = (value ^ (value >> 27)) * 0x94d049bb133111eb;
+  return value ^ (value >> 31);
+}
+
+// random keys of cards for each player's current and collected cards and for
+// each position within the trick, see TarokState::Hash()
+struct HashKeys {
+  std::array<std::array<uint64_t, 54>, 4> players_cards{};
+  std::array<std::array<uint64_t, 54>, 4> players_collected_cards{};
+  std::array<std::array<uint64_t, 54>, 4> trick_cards{};
+};
+
+static constexpr HashKeys InitializeHashKeys() {
+  HashKeys keys;
+  uint64_t seed = 0;
+  for (int i = 0; i < 4; i++) {
+    for (int j = 0; j < 54; j++) {
+      keys.players_cards[i][j] = SplitMix64(seed++);
+      keys.players_collected_cards[i][j] = SplitMix64(seed++);
+      keys.trick_cards[i][j] = SplitMix64(seed++);
+    }
+  }
+  return keys;
+}
+
+static constexpr HashKeys kHashKeys = InitializeHashKeys();
+
+static uint64_t CardSetHash(CardSet cards,
+                            const std::array<uint64_t, 54>& keys) {
+  uint64_t hash = 0;
+  for (; cards != kEmptyCardSet; cards &= cards - 1)
+    hash ^= keys[LowestCardAction(cards)];
+  return hash;
+}
+
+// hash of everything but the card sets, these change with most actions and
+// are cheap to hash from scratch
+static uint64_t ScalarsAndTrickCardsHash(const TarokStateData& data) {
+  auto byte = [](auto value, int index) {
+    return uint64_t{static_cast<uint8_t>(value)} << (8 * index);
+  };
+  uint64_t scalars =
+      byte(data.current_game_phase, 0) | byte(data.current_player, 1) |
+      byte(data.selected_contract, 2) | byte(data.declarer, 3) |
+      byte(data.called_king, 4) | byte(data.declarer_partner, 5) |
+      byte(data.captured_mond_player, 6) | byte(data.talon_positions, 7);
+  uint64_t bids =
+      byte(data.players_bids[0], 0) | byte(data.players_bids[1], 1) |
+      byte(data.players_bids[2], 2) | byte(data.players_bids[3], 3);
+  uint64_t hash = SplitMix64(scalars ^ (bids << 29 | bids >> 35));
+  int index = 0;
+  for (auto const& action : data.trick_cards)
+    hash ^= kHashKeys.trick_cards[index++][action];
+  return hash;
+}
+
+// what is observed about an action, see InformationStateKeys
+enum class Observation : uint64_t {
+  kDealtCard,
+  kBid,
+  kCalledKing,
+  kTalonCard,
+  kTalonSet,
+  kDiscardedCard,
+  kTrickCard,
+  kGiftedCard
+};
+
+static constexpr uint64_t ObservationKey(int position, Observation observation,
+                                         int value) {
+  return SplitMix64(uint64_t{1} << 63 | uint64_t(position) << 20 |
+                    static_cast<uint64_t>(observation) << 12 | value);
+}
+
+static constexpr std::array<uint64_t, 54> InitializeDealtCardKeys() {
+  std::array<uint64_t, 54> keys{};
+  for (int i = 0; i < 54; i++)
+    keys[i] = ObservationKey(0, Observation::kDealtCard, i);
+  return keys;
+}
+
+// dealt cards are always the first observation
+static constexpr std::array<uint64_t, 54> kDealtCardKeys =
+    InitializeDealtCardKeys();
+
 // state definition
-TarokState::TarokState(std::shared_ptr<const open_spiel::Game> game)
+TarokState::TarokState(std::shared_ptr<const open_spiel::Game> game,
+                       int deal_seed)
     : open_spiel::State(game),
-      tarok_parent_game_(std::static_pointer_cast<const TarokGame>(game)) {
-  players_bids_.reserve(num_players_);
-  players_bids_.insert(players_bids_.end(), num_players_, kInvalidBidAction);
-  players_collected_cards_.reserve(num_players_);
-  players_collected_cards_.insert(players_collected_cards_.end(), num_players_,
-                                  std::vector<open_spiel::Action>());
-  players_info_states_.reserve(num_players_);
-  players_info_states_.insert(players_info_states_.end(), num_players_, "");
+      tarok_parent_game_(static_cast<const TarokGame*>(game.get())) {
+  data_.deal_seed = deal_seed;
+  public_inferences_.possible_card_holders.fill((1 << num_players_) - 1);
+  hash_ = ComputeHash();
+}
+
+void TarokState::ResetForDeal(int deal_seed) {
+  data_ = TarokStateData{};
+  data_.deal_seed = deal_seed;
+  public_inferences_ = PublicInferences{};
+  public_inferences_.possible_card_holders.fill((1 << num_players_) - 1);
+  winning_trick_cards_indices_ = {};
+  information_state_keys_ = InformationStateKeys{};
+  hash_ = ComputeHash();
+  history_.clear();
+  move_number_ = 0;
 }
 
 open_spiel::Player TarokState::CurrentPlayer() const {
-  switch (current_game_phase_) {
+  switch (data_.current_game_phase) {
     case GamePhase::kCardDealing:
       return open_spiel::kChancePlayerId;
     case GamePhase::kFinished:
       return open_spiel::kTerminalPlayerId;
     default:
-      return current_player_;
+      return data_.current_player;
   }
 }
 
 bool TarokState::IsTerminal() const {
-  return current_game_phase_ == GamePhase::kFinished;
+  return data_.current_game_phase == GamePhase::kFinished;
 }
 
-GamePhase TarokState::CurrentGamePhase() const { return current_game_phase_; }
+GamePhase TarokState::CurrentGamePhase() const {
+  return data_.current_game_phase;
+}
+
+int TarokState::DealSeed() const { return data_.deal_seed; }
 
 std::vector<open_spiel::Action> TarokState::PlayerCards(
     open_spiel::Player player) const {
-  if (current_game_phase_ == GamePhase::kCardDealing) return {};
-  return players_cards_.at(player);
+  if (data_.current_game_phase == GamePhase::kCardDealing) return {};
+  return CardSetToActions(data_.players_cards.at(player));
 }
 
 ContractName TarokState::SelectedContractName() const {
-  if (current_game_phase_ == GamePhase::kCardDealing ||
-      current_game_phase_ == GamePhase::kBidding) {
+  if (data_.current_game_phase == GamePhase::kCardDealing ||
+      data_.current_game_phase == GamePhase::kBidding) {
     return ContractName::kNotSelected;
   }
-  return selected_contract_->name;
+  return SelectedContract().name;
 }
 
-std::vector<open_spiel::Action> TarokState::Talon() const { return talon_; }
+std::vector<open_spiel::Action> TarokState::Talon() const {
+  std::vector<open_spiel::Action> talon;
+  talon.reserve(TalonSize());
+  for (int i = 0; i < 6; i++) {
+    if (data_.talon_positions & (1 << i)) talon.push_back(data_.talon.at(i));
+  }
+  return talon;
+}
 
 std::vector<std::vector<open_spiel::Action>> TarokState::TalonSets() const {
-  if (current_game_phase_ != GamePhase::kTalonExchange) return {};
+  if (data_.current_game_phase != GamePhase::kTalonExchange) return {};
 
-  int num_talon_sets = talon_.size() / selected_contract_->num_talon_exchanges;
+  std::vector<open_spiel::Action> talon = Talon();
+  int num_talon_sets = talon.size() / SelectedContract().num_talon_exchanges;
   std::vector<std::vector<open_spiel::Action>> talon_sets;
   talon_sets.reserve(num_talon_sets);
 
-  auto begin = talon_.begin();
+  auto begin = talon.begin();
   for (int i = 0; i < num_talon_sets; i++) {
     talon_sets.push_back(std::vector<open_spiel::Action>(
-        begin, begin + selected_contract_->num_talon_exchanges));
-    std::advance(begin, selected_contract_->num_talon_exchanges);
+        begin, begin + SelectedContract().num_talon_exchanges));
+    begin += SelectedContract().num_talon_exchanges;
   }
   return talon_sets;
 }
 
 std::vector<open_spiel::Action> TarokState::TrickCards() const {
-  return trick_cards_;
+  return data_.trick_cards.ToVector();
+}
+
+CardSet TarokState::PlayerCardSet(open_spiel::Player player) const {
+  return data_.players_cards.at(player);
+}
+
+CardSet TarokState::CollectedCardSet(open_spiel::Player player) const {
+  return data_.players_collected_cards.at(player);
+}
+
+CardSet TarokState::PlayedCardSet(open_spiel::Player player) const {
+  return data_.players_played_cards.at(player);
+}
+
+open_spiel::Player TarokState::Declarer() const { return data_.declarer; }
+
+open_spiel::Player TarokState::DeclarerPartner() const {
+  return data_.declarer_partner;
+}
+
+open_spiel::Action TarokState::CalledKing() const { return data_.called_king; }
+
+bool TarokState::CalledKingInTalon() const {
+  return data_.called_king_in_talon;
+}
+
+open_spiel::Player TarokState::CapturedMondPlayer() const {
+  return data_.captured_mond_player;
+}
+
+CardSet TarokState::PubliclyExcludedCards(open_spiel::Player player) const {
+  SPIEL_CHECK_GE(player, 0);
+  SPIEL_CHECK_LT(player, num_players_);
+  return public_inferences_.players_excluded_cards.at(player);
+}
+
+uint8_t TarokState::PossibleCardHolders(open_spiel::Action action_id) const {
+  return public_inferences_.possible_card_holders.at(action_id);
+}
+
+bool TarokState::IsPubliclyVoidInSuit(open_spiel::Player player,
+                                      CardSuit suit) const {
+  return (SuitToCardSet(suit) & ~PubliclyExcludedCards(player)) ==
+         kEmptyCardSet;
 }
 
 std::vector<open_spiel::Action> TarokState::LegalActions() const {
+  // legal actions are always returned in ascending order, note that the
+  // conversion works for any bitmask and not just for card sets
+  return CardSetToActions(LegalActionsBitmask());
+}
+
+ActionBitmask TarokState::LegalActionsBitmask() const {
+  if (num_players_ == 3)
+    return LegalActionsBitmask<3>();
+  else
+    return LegalActionsBitmask<4>();
+}
+
+template <int kNumPlayers>
+ActionBitmask TarokState::LegalActionsBitmask() const {
   // all card actions are encoded as 0, 1, ..., 52, 53 and correspond to card
-  // indices wrt. tarok_parent_game_->card_deck_, card actions are returned:
+  // indices wrt. InitializeCardDeck(), card actions are returned:
   //   - in the king calling phase
   //   - by LegalActionsInTalonExchange() after the talon set is selected (i.e.
   //     when discarding the cards)
   //   - by LegalActionsInTricksPlaying()
-  switch (current_game_phase_) {
+  switch (data_.current_game_phase) {
     case GamePhase::kCardDealing:
       // return a dummy action due to implicit stochasticity
-      return {0};
+      return ActionToBitmask(0);
     case GamePhase::kBidding:
-      return LegalActionsInBidding();
+      return LegalActionsInBidding<kNumPlayers>();
     case GamePhase::kKingCalling:
-      return {kKingOfHeartsAction, kKingOfDiamondsAction, kKingOfSpadesAction,
-              kKingOfClubsAction};
+      return kKingsCardSet;
     case GamePhase::kTalonExchange:
       return LegalActionsInTalonExchange();
     case GamePhase::kTricksPlaying:
       return LegalActionsInTricksPlaying();
     case GamePhase::kFinished:
-      return {};
+      return ActionBitmask{0};
   }
 }
 
-std::vector<open_spiel::Action> TarokState::LegalActionsInBidding() const {
+template <int kNumPlayers>
+ActionBitmask TarokState::LegalActionsInBidding() const {
   // actions 1 - 12 correspond to contracts in tarok_parent_game_->contracts_
   // respectively, action 0 means pass
-  auto it = std::max_element(players_bids_.begin(), players_bids_.end());
+  // bids of non-existing players are kept at kInvalidBidAction
+  auto it =
+      std::max_element(data_.players_bids.begin(), data_.players_bids.end());
   int max_bid = *it;
-  int max_bid_player = it - players_bids_.begin();
+  int max_bid_player = it - data_.players_bids.begin();
 
-  std::vector<open_spiel::Action> actions;
-  if (current_player_ == 0 &&
-      players_bids_.at(current_player_) == kInvalidBidAction &&
-      AllButCurrentPlayerPassedBidding()) {
+  ActionBitmask actions = 0;
+  if (data_.current_player == 0 &&
+      data_.players_bids.at(data_.current_player) == kInvalidBidAction &&
+      AllButCurrentPlayerPassedBidding<kNumPlayers>()) {
     // no bidding has happened before so forehand can
     // bid any contract but can't pass
-    actions.insert(actions.end(), {kBidKlopAction, kBidThreeAction});
-  } else if (!AllButCurrentPlayerPassedBidding()) {
+    actions |=
+        ActionToBitmask(kBidKlopAction) | ActionToBitmask(kBidThreeAction);
+  } else if (!AllButCurrentPlayerPassedBidding<kNumPlayers>()) {
     // other players still playing
-    actions.push_back(kBidPassAction);
+    actions |= ActionToBitmask(kBidPassAction);
   }
 
   for (int action = 3; action <= 12; action++) {
-    if (num_players_ == 3 && action >= kBidSoloThreeAction &&
+    if (kNumPlayers == 3 && action >= kBidSoloThreeAction &&
         action <= kBidSoloOneAction) {
       // skip solo contracts for three players
       continue;
@@ -129,194 +308,38 @@ std::vector<open_spiel::Action> TarokState::LegalActionsInBidding() const {
       continue;
     }
     if ((action > max_bid) ||
-        (action == max_bid && current_player_ <= max_bid_player)) {
-      actions.push_back(action);
+        (action == max_bid && data_.current_player <= max_bid_player)) {
+      actions |= ActionToBitmask(action);
     }
   }
   return actions;
 }
 
-std::vector<open_spiel::Action> TarokState::LegalActionsInTalonExchange()
-    const {
-  if (talon_.size() == 6) {
+ActionBitmask TarokState::LegalActionsInTalonExchange() const {
+  if (TalonSize() == 6) {
     // choosing one of the talon card sets where actions are encoded as
     // 0, 1, 2, etc. from left to right, i.e. 0 is the leftmost talon set
     // as returned by TalonSets()
-    std::vector<open_spiel::Action> actions(
-        6 / selected_contract_->num_talon_exchanges);
-    std::iota(actions.begin(), actions.end(), 0);
-    return actions;
+    return ActionToBitmask(6 / SelectedContract().num_talon_exchanges) - 1;
   }
   // prevent discarding of taroks and kings
-  std::vector<open_spiel::Action> actions;
-  for (auto const& action : players_cards_.at(current_player_)) {
-    const Card& card = ActionToCard(action);
-    if (card.suit != CardSuit::kTaroks && card.points != 5)
-      actions.push_back(action);
-  }
+  CardSet player_cards = data_.players_cards.at(data_.current_player);
+  CardSet cards =
+      player_cards & ~SuitToCardSet(CardSuit::kTaroks) & ~kKingsCardSet;
   // allow discarding of taroks (except of trula) if player has no other choice
-  if (actions.empty()) {
-    for (auto const& action : players_cards_.at(current_player_)) {
-      if (ActionToCard(action).points != 5) actions.push_back(action);
-    }
-  }
-  return actions;
-}
-
-std::vector<open_spiel::Action> TarokState::LegalActionsInTricksPlaying()
-    const {
-  if (trick_cards_.empty()) {
-    // trick opening, i.e. the current player is choosing
-    // the first card for this trick
-    if (selected_contract_->is_negative)
-      return RemovePagatIfNeeded(players_cards_.at(current_player_));
-    return players_cards_.at(current_player_);
-  } else {
-    // trick following
-    return LegalActionsInTricksPlayingFollowing();
-  }
-}
-
-std::vector<open_spiel::Action>
-TarokState::LegalActionsInTricksPlayingFollowing() const {
-  auto [can_follow_suit, cant_follow_suit_but_has_tarok] =
-      CanFollowSuitOrCantButHasTarok();
-
-  CardSuit take_suit;
-  if (can_follow_suit) {
-    take_suit = ActionToCard(trick_cards_.front()).suit;
-  } else if (cant_follow_suit_but_has_tarok) {
-    take_suit = CardSuit::kTaroks;
-  } else {
-    // can't follow suit and doesn't have taroks so any card can be played
-    return players_cards_.at(current_player_);
-  }
-
-  if (selected_contract_->is_negative)
-    return TakeSuitFromPlayerCardsInNegativeContracts(take_suit);
-  else
-    return TakeSuitFromPlayerCardsInPositiveContracts(take_suit);
-}
-
-std::tuple<bool, bool> TarokState::CanFollowSuitOrCantButHasTarok() const {
-  const Card& opening_card = ActionToCard(trick_cards_.front());
-  bool has_taroks = false;
-  for (auto const& action : players_cards_.at(current_player_)) {
-    const Card& current_card = ActionToCard(action);
-    if (current_card.suit == opening_card.suit) {
-      // note that the second return value is irrelevant in this case
-      return {true, false};
-    }
-    if (current_card.suit == CardSuit::kTaroks) {
-      has_taroks = true;
-    }
-  }
-  return {false, has_taroks};
-}
-
-std::vector<open_spiel::Action>
-TarokState::TakeSuitFromPlayerCardsInNegativeContracts(CardSuit suit) const {
-  bool player_has_pagat =
-      ActionInActions(kPagatAction, players_cards_.at(current_player_));
-  if (player_has_pagat && ActionInActions(kMondAction, trick_cards_) &&
-      ActionInActions(kSkisAction, trick_cards_)) {
-    // the emperor trick, i.e. pagat has to be played as it is the only card
-    // that will win the trick
-    return {kPagatAction};
-  }
-
-  absl::optional<open_spiel::Action> action_to_beat =
-      ActionToBeatInNegativeContracts(suit);
-  std::vector<open_spiel::Action> actions;
-
-  if (action_to_beat) {
-    const Card& card_to_beat = ActionToCard(*action_to_beat);
-    auto const& player_cards = players_cards_.at(current_player_);
-    // a higher card only has to be played when the player actually has a higher
-    // card otherwise any card of the suit can be played
-    bool has_higher_card = false;
-    for (auto const& action : player_cards) {
-      const Card& current_card = ActionToCard(action);
-      if (current_card.suit == suit && current_card.rank > card_to_beat.rank) {
-        has_higher_card = true;
-        break;
-      }
-    }
-    // collect the actual cards
-    for (auto const& action : player_cards) {
-      const Card& current_card = ActionToCard(action);
-      if (current_card.suit == suit &&
-          (!has_higher_card || current_card.rank > card_to_beat.rank)) {
-        actions.push_back(action);
-      }
-    }
-  } else {
-    // no need to beat any card so simply return all cards of the correct suit
-    actions = TakeSuitFromPlayerCardsInPositiveContracts(suit);
-  }
-
-  if (player_has_pagat)
-    return RemovePagatIfNeeded(actions);
-  else
-    return actions;
-}
-
-absl::optional<open_spiel::Action> TarokState::ActionToBeatInNegativeContracts(
-    CardSuit suit) const {
-  // there are two cases where no card has to be beaten; the player is following
-  // a colour suit and there is already at least one tarok in trick_cards_ or
-  // the player is forced to play a tarok and there are no taroks in
-  // trick_cards_
-  bool tarok_in_trick_cards = false;
-  for (auto const& action : trick_cards_) {
-    if (ActionToCard(action).suit == CardSuit::kTaroks) {
-      tarok_in_trick_cards = true;
-      break;
-    }
-  }
-  if ((suit != CardSuit::kTaroks && tarok_in_trick_cards) ||
-      (suit == CardSuit::kTaroks && !tarok_in_trick_cards)) {
-    return {};
-  }
-  // the specified suit should be present in trick_cards_ from here on because
-  // it is either a suit of the opening card or CardSuit::kTaroks with existing
-  // taroks in trick_cards_
-  open_spiel::Action action_to_beat = trick_cards_.front();
-  for (int i = 1; i < trick_cards_.size(); i++) {
-    const Card& card_to_beat = ActionToCard(action_to_beat);
-    const Card& current_card = ActionToCard(trick_cards_.at(i));
-    if (current_card.suit == suit && current_card.rank > card_to_beat.rank)
-      action_to_beat = trick_cards_.at(i);
-  }
-  return action_to_beat;
-}
-
-std::vector<open_spiel::Action> TarokState::RemovePagatIfNeeded(
-    const std::vector<open_spiel::Action>& actions) const {
-  if (actions.size() > 1) {
-    // mustn't play pagat unless it's the only card, note that actions
-    // can be all player's cards or a subset already filtered by the caller
-    std::vector<open_spiel::Action> actions_no_pagat;
-    for (auto const& action : actions) {
-      if (action != kPagatAction) actions_no_pagat.push_back(action);
-    }
-    return actions_no_pagat;
-  }
-  return actions;
+  if (cards == kEmptyCardSet)
+    cards = player_cards & ~kKingsCardSet & ~kTrulaCardSet;
+  return cards;
 }
 
-std::vector<open_spiel::Action>
-TarokState::TakeSuitFromPlayerCardsInPositiveContracts(CardSuit suit) const {
-  std::vector<open_spiel::Action> actions;
-  for (auto const& action : players_cards_.at(current_player_)) {
-    if (ActionToCard(action).suit == suit) actions.push_back(action);
-  }
-  return actions;
+ActionBitmask TarokState::LegalActionsInTricksPlaying() const {
+  return LegalTrickCards(data_.players_cards.at(data_.current_player),
+                         data_.trick_cards, SelectedContract().is_negative);
 }
 
 std::string TarokState::ActionToString(open_spiel::Player player,
                                        open_spiel::Action action_id) const {
-  switch (current_game_phase_) {
+  switch (data_.current_game_phase) {
     case GamePhase::kCardDealing:
       // return a dummy action due to implicit stochasticity
       return "Deal";
@@ -328,7 +351,8 @@ std::string TarokState::ActionToString(open_spiel::Player player,
     case GamePhase::kTricksPlaying:
       return CardActionToString(action_id);
     case GamePhase::kTalonExchange:
-      if (talon_.size() == 6) return absl::StrCat("Talon set ", action_id + 1);
+      if (TalonSize() == 6)
+        return absl::StrCat("Talon set ", action_id + 1);
       return CardActionToString(action_id);
     case GamePhase::kFinished:
       return "";
@@ -336,319 +360,637 @@ std::string TarokState::ActionToString(open_spiel::Player player,
 }
 
 std::string TarokState::CardActionToString(open_spiel::Action action_id) const {
-  return ActionToCard(action_id).ToString();
+  return CardDeck().at(action_id).ToString();
 }
 
 open_spiel::ActionsAndProbs TarokState::ChanceOutcomes() const {
-  if (current_game_phase_ == GamePhase::kCardDealing) {
+  if (data_.current_game_phase == GamePhase::kCardDealing) {
     // return a dummy action with probability 1 due to implicit stochasticity
     return {{0, 1.0}};
   }
   return {};
 }
 
+void TarokState::ApplyTrustedAction(open_spiel::Action action_id) {
+#ifndef NDEBUG
+  CheckLegalAction(action_id);
+#endif
+  // mirrors open_spiel::State::ApplyAction(), note that history_ has to be
+  // modified after the action is applied
+  open_spiel::Player player = CurrentPlayer();
+  DoApplyTrustedAction(action_id);
+  history_.push_back({player, action_id});
+  ++move_number_;
+}
+
 void TarokState::DoApplyAction(open_spiel::Action action_id) {
-  if (!ActionInActions(action_id, LegalActions())) {
+  CheckLegalAction(action_id);
+  DoApplyTrustedAction(action_id);
+}
+
+void TarokState::CheckLegalAction(open_spiel::Action action_id) const {
+  if (action_id < 0 || action_id >= num_distinct_actions_ ||
+      (LegalActionsBitmask() & ActionToBitmask(action_id)) == 0) {
     open_spiel::SpielFatalError(absl::StrCat(
         "Action ", action_id, " is not valid in the current state."));
   }
-  switch (current_game_phase_) {
+}
+
+void TarokState::DoApplyTrustedAction(open_spiel::Action action_id) {
+  if (num_players_ == 3)
+    DoApplyTrustedAction<3>(action_id);
+  else
+    DoApplyTrustedAction<4>(action_id);
+}
+
+template <int kNumPlayers>
+void TarokState::DoApplyTrustedAction(open_spiel::Action action_id) {
+  const TarokStateData previous_data = data_;
+  UpdateInformationStateKeys<kNumPlayers>(action_id, false);
+  switch (data_.current_game_phase) {
     case GamePhase::kCardDealing:
       DoApplyActionInCardDealing();
       break;
     case GamePhase::kBidding:
-      DoApplyActionInBidding(action_id);
+      DoApplyActionInBidding<kNumPlayers>(action_id);
       break;
     case GamePhase::kKingCalling:
       DoApplyActionInKingCalling(action_id);
       break;
     case GamePhase::kTalonExchange:
-      DoApplyActionInTalonExchange(action_id);
+      DoApplyActionInTalonExchange<kNumPlayers>(action_id);
       break;
     case GamePhase::kTricksPlaying:
-      DoApplyActionInTricksPlaying(action_id);
+      DoApplyActionInTricksPlaying<kNumPlayers>(action_id);
       break;
     case GamePhase::kFinished:
       open_spiel::SpielFatalError("Calling DoApplyAction in a terminal state.");
   }
+  // cards played in tricks are excluded as they are played, all other actions
+  // are rare enough to recompute the inferences
+  if (previous_data.current_game_phase != GamePhase::kTricksPlaying)
+    UpdatePubliclyExcludedCards();
+  UpdateHash<kNumPlayers>(previous_data);
+}
+
+uint64_t TarokState::ComputeHash() const {
+  uint64_t hash = ScalarsAndTrickCardsHash(data_);
+  for (int i = 0; i < num_players_; i++) {
+    hash ^= CardSetHash(data_.players_cards[i], kHashKeys.players_cards[i]);
+    hash ^= CardSetHash(data_.players_collected_cards[i],
+                        kHashKeys.players_collected_cards[i]);
+  }
+  return hash;
+}
+
+template <int kNumPlayers>
+void TarokState::UpdateHash(const TarokStateData& previous_data) {
+  // only the cards that moved are hashed, i.e. a card or two per action
+  // outside of dealing
+  hash_ ^= ScalarsAndTrickCardsHash(previous_data) ^
+           ScalarsAndTrickCardsHash(data_);
+  for (int i = 0; i < kNumPlayers; i++) {
+    hash_ ^= CardSetHash(
+        previous_data.players_cards[i] ^ data_.players_cards[i],
+        kHashKeys.players_cards[i]);
+    hash_ ^= CardSetHash(previous_data.players_collected_cards[i] ^
+                             data_.players_collected_cards[i],
+                         kHashKeys.players_collected_cards[i]);
+  }
 }
 
 void TarokState::DoApplyActionInCardDealing() {
-  // do the actual sampling here due to implicit stochasticity
+  // do the actual sampling here due to implicit stochasticity, the state's
+  // own RNG makes the deal reproducible
+  std::mt19937 rng(data_.deal_seed);
   do {
-    // hands without taroks are illegal
-    std::tie(talon_, players_cards_) =
-        DealCards(num_players_, tarok_parent_game_->RNG());
+    // hands without taroks are illegal, such deals are rare (less than one
+    // in three hundred with four players) so redealing is cheaper than
+    // sampling valid deals directly
+    auto dealt = DealCardSets(num_players_, rng());
+    data_.talon = dealt.talon;
+    data_.players_cards = dealt.players_cards;
   } while (AnyPlayerWithoutTaroks());
-  current_game_phase_ = GamePhase::kBidding;
+  data_.talon_positions = kAllTalonPositions;
+  StartBiddingPhase();
+}
+
+template <int kNumPlayers>
+void TarokState::UpdateInformationStateKeys(open_spiel::Action action_id,
+                                            bool undo) {
+  // mirrors what is appended to the info states when applying the action
+  int observers = (1 << kNumPlayers) - 1;
+  Observation observation;
+  bool shows_talon = false;
+  open_spiel::Action gift_action = open_spiel::kInvalidAction;
+  switch (data_.current_game_phase) {
+    case GamePhase::kBidding:
+      observation = Observation::kBid;
+      break;
+    case GamePhase::kKingCalling:
+      observation = Observation::kCalledKing;
+      break;
+    case GamePhase::kTalonExchange:
+      if (TalonSize() == 6) {
+        observation = Observation::kTalonSet;
+        shows_talon = true;
+      } else {
+        observation = Observation::kDiscardedCard;
+        if (CardActionSuit(action_id) != CardSuit::kTaroks)
+          observers = 1 << data_.current_player;
+      }
+      break;
+    case GamePhase::kTricksPlaying:
+      observation = Observation::kTrickCard;
+      if (data_.trick_cards.size() == kNumPlayers - 1 &&
+          SelectedContract().name == ContractName::kKlop && TalonSize() > 0) {
+        gift_action = data_.talon.at(__builtin_ctz(data_.talon_positions));
+      }
+      break;
+    default:
+      // the dealt cards are observed when the bidding phase starts
+      return;
+  }
+
+  for (int i = 0; i < kNumPlayers; i++) {
+    if (!(observers & (1 << i))) continue;
+    uint8_t& num_observed = information_state_keys_.num_observed_actions[i];
+    int position = undo ? --num_observed : num_observed++;
+    uint64_t key = ObservationKey(position, observation, action_id);
+    if (shows_talon) {
+      for (int j = 0; j < 6; j++) {
+        key ^= ObservationKey(position, Observation::kTalonCard,
+                              j * 64 + data_.talon.at(j));
+      }
+    }
+    if (gift_action != open_spiel::kInvalidAction)
+      key ^= ObservationKey(position, Observation::kGiftedCard, gift_action);
+    information_state_keys_.keys[i] ^= key;
+  }
+}
+
+void TarokState::ReplaceHiddenCards(const std::array<CardSet, 4>& players_cards,
+                                    const CardActions<6>& talon,
+                                    CardSet discarded_cards) {
+  std::array<CardSet, 4> previous_dealt_cards{};
+  for (int i = 0; i < num_players_; i++) {
+    previous_dealt_cards.at(i) = DealtPlayerCards(i);
+    SPIEL_CHECK_EQ(CardSetSize(players_cards.at(i)),
+                   CardSetSize(data_.players_cards.at(i)));
+    data_.players_cards.at(i) = players_cards.at(i);
+  }
+
+  if (!talon.empty()) {
+    SPIEL_CHECK_EQ(talon.size(), TalonSize());
+    int talon_index = 0;
+    for (int i = 0; i < 6; i++) {
+      if (data_.talon_positions & (1 << i))
+        data_.talon.at(i) = talon.at(talon_index++);
+    }
+  }
+
+  // discarded taroks are shown so only the discarding actions of other cards
+  // are replaced, these directly precede the cards played in tricks
+  CardSet taroks = SuitToCardSet(CardSuit::kTaroks);
+  CardSet& previous_discarded_cards = public_inferences_.discarded_cards;
+  SPIEL_CHECK_EQ(discarded_cards & taroks, previous_discarded_cards & taroks);
+  SPIEL_CHECK_EQ(CardSetSize(discarded_cards),
+                 CardSetSize(previous_discarded_cards));
+  if (discarded_cards != previous_discarded_cards) {
+    CardSet& declarer_collected_cards =
+        data_.players_collected_cards.at(data_.declarer);
+    declarer_collected_cards =
+        (declarer_collected_cards & ~previous_discarded_cards) |
+        discarded_cards;
+    previous_discarded_cards = discarded_cards;
+    CardSet hidden_discarded_cards = discarded_cards & ~taroks;
+    int discarded_end = history_.size() - NumCardsPlayedInTricks();
+    for (int i = discarded_end - CardSetSize(discarded_cards);
+         i < discarded_end; i++) {
+      open_spiel::Action previous_action = history_.at(i).action;
+      if (CardActionInCardSet(previous_action, taroks)) continue;
+      history_.at(i).action = LowestCardAction(hidden_discarded_cards);
+      hidden_discarded_cards &= hidden_discarded_cards - 1;
+      ReplaceDiscardedCardInInformationStateKey(i, previous_action);
+    }
+  }
+
+  // the partner is whoever holds the called king unless it was played already
+  // or it's in talon
+  if (data_.called_king != open_spiel::kInvalidAction &&
+      !data_.called_king_in_talon) {
+    for (int i = 0; i < num_players_; i++) {
+      if (CardActionInCardSet(data_.called_king, data_.players_cards.at(i))) {
+        data_.declarer_partner =
+            i == data_.declarer ? open_spiel::kInvalidPlayer : i;
+      }
+    }
+  }
+
+  hash_ = ComputeHash();
+  for (int i = 0; i < num_players_; i++)
+    ReplaceDealtCardsInInformationStateKey(i, previous_dealt_cards.at(i));
+}
+
+void TarokState::ReplaceDealtCardsInInformationStateKey(
+    open_spiel::Player player, CardSet previous_dealt_cards) {
+  information_state_keys_.keys.at(player) ^= CardSetHash(
+      previous_dealt_cards ^ DealtPlayerCards(player), kDealtCardKeys);
+}
+
+void TarokState::ReplaceDiscardedCardInInformationStateKey(
+    int history_index, open_spiel::Action previous_action) {
+  // the declarer observes all actions so their positions are the same as
+  // their history indices
+  information_state_keys_.keys.at(data_.declarer) ^=
+      ObservationKey(history_index, Observation::kDiscardedCard,
+                     previous_action) ^
+      ObservationKey(history_index, Observation::kDiscardedCard,
+                     history_.at(history_index).action);
+}
+
+void TarokState::StartBiddingPhase() {
+  data_.current_game_phase = GamePhase::kBidding;
   // lower player indices correspond to higher bidding priority,
   // i.e. 0 is the forehand, num_players - 1 is the dealer
-  current_player_ = 1;
+  data_.current_player = 1;
 
   // add private cards to info states
   for (int i = 0; i < num_players_; i++) {
-    AppendToInformationState(
-        i, absl::StrCat(absl::StrJoin(players_cards_.at(i), ","), ";"));
+    information_state_keys_.keys[i] =
+        CardSetHash(data_.players_cards[i], kDealtCardKeys);
+    information_state_keys_.num_observed_actions[i] = 1;
   }
 }
 
 bool TarokState::AnyPlayerWithoutTaroks() const {
-  // actions are sorted, i.e. taroks are always at the beginning
   for (int i = 0; i < num_players_; i++) {
-    if (ActionToCard(players_cards_.at(i).front()).suit != CardSuit::kTaroks) {
+    if ((data_.players_cards.at(i) & SuitToCardSet(CardSuit::kTaroks)) ==
+        kEmptyCardSet) {
       return true;
     }
   }
   return false;
 }
 
+template <int kNumPlayers>
 void TarokState::DoApplyActionInBidding(open_spiel::Action action_id) {
-  players_bids_.at(current_player_) = action_id;
-  AppendToAllInformationStates(std::to_string(action_id));
-  if (AllButCurrentPlayerPassedBidding()) {
-    FinishBiddingPhase(action_id);
-    AppendToAllInformationStates(";");
+  data_.players_bids.at(data_.current_player) = action_id;
+  if (AllButCurrentPlayerPassedBidding<kNumPlayers>()) {
+    FinishBiddingPhase<kNumPlayers>(action_id);
   } else {
     do {
-      NextPlayer();
-    } while (players_bids_.at(current_player_) == kBidPassAction);
-    AppendToAllInformationStates(",");
+      NextPlayer<kNumPlayers>();
+    } while (data_.players_bids.at(data_.current_player) == kBidPassAction);
   }
 }
 
+template <int kNumPlayers>
 bool TarokState::AllButCurrentPlayerPassedBidding() const {
-  for (int i = 0; i < num_players_; i++) {
-    if (i == current_player_) continue;
-    if (players_bids_.at(i) != kBidPassAction) return false;
+  for (int i = 0; i < kNumPlayers; i++) {
+    if (i == data_.current_player) continue;
+    if (data_.players_bids.at(i) != kBidPassAction) return false;
   }
   return true;
 }
 
+template <int kNumPlayers>
 void TarokState::FinishBiddingPhase(open_spiel::Action action_id) {
-  declarer_ = current_player_;
-  selected_contract_ = &tarok_parent_game_->contracts_.at(action_id - 1);
-  if (num_players_ == 4 && selected_contract_->needs_king_calling)
-    current_game_phase_ = GamePhase::kKingCalling;
-  else if (selected_contract_->NeedsTalonExchange())
-    current_game_phase_ = GamePhase::kTalonExchange;
+  data_.declarer = data_.current_player;
+  data_.selected_contract = action_id - 1;
+  if (kNumPlayers == 4 && SelectedContract().needs_king_calling)
+    data_.current_game_phase = GamePhase::kKingCalling;
+  else if (SelectedContract().NeedsTalonExchange())
+    data_.current_game_phase = GamePhase::kTalonExchange;
   else
     StartTricksPlayingPhase();
 }
 
 void TarokState::DoApplyActionInKingCalling(open_spiel::Action action_id) {
-  called_king_ = action_id;
-  if (ActionInActions(action_id, talon_)) {
-    called_king_in_talon_ = true;
+  data_.called_king = action_id;
+  if (CardActionInCardSet(action_id, TalonCardSet())) {
+    data_.called_king_in_talon = true;
   } else {
     for (int i = 0; i < num_players_; i++) {
-      if (i == current_player_) {
+      if (i == data_.current_player) {
         continue;
-      } else if (ActionInActions(action_id, players_cards_.at(i))) {
-        declarer_partner_ = i;
+      } else if (CardActionInCardSet(action_id, data_.players_cards.at(i))) {
+        data_.declarer_partner = i;
         break;
       }
     }
   }
-  current_game_phase_ = GamePhase::kTalonExchange;
-  AppendToAllInformationStates(absl::StrCat(action_id, ";"));
+  data_.current_game_phase = GamePhase::kTalonExchange;
 }
 
+template <int kNumPlayers>
 void TarokState::DoApplyActionInTalonExchange(open_spiel::Action action_id) {
-  auto& player_cards = players_cards_.at(current_player_);
-
-  if (talon_.size() == 6) {
-    // add all talon cards to info states
-    AppendToAllInformationStates(absl::StrCat(absl::StrJoin(talon_, ","), ";"));
+  auto& player_cards = data_.players_cards.at(data_.current_player);
 
+  if (TalonSize() == 6) {
     // choosing one of the talon card sets
-    int set_begin = action_id * selected_contract_->num_talon_exchanges;
-    int set_end = set_begin + selected_contract_->num_talon_exchanges;
+    int set_begin = action_id * SelectedContract().num_talon_exchanges;
+    int set_end = set_begin + SelectedContract().num_talon_exchanges;
 
-    bool mond_in_talon = ActionInActions(kMondAction, talon_);
+    bool mond_in_talon = CardActionInCardSet(kMondAction, TalonCardSet());
     bool mond_in_selected_talon_set = false;
     for (int i = set_begin; i < set_end; i++) {
-      player_cards.push_back(talon_.at(i));
-      if (talon_.at(i) == kMondAction) mond_in_selected_talon_set = true;
+      player_cards |= CardActionToCardSet(data_.talon.at(i));
+      public_inferences_.selected_talon_set |=
+          CardActionToCardSet(data_.talon.at(i));
+      if (data_.talon.at(i) == kMondAction) mond_in_selected_talon_set = true;
     }
     if (mond_in_talon && !mond_in_selected_talon_set) {
       // the captured mond penalty applies if mond is in talon and not part of
       // the selected set
-      captured_mond_player_ = current_player_;
+      data_.captured_mond_player = data_.current_player;
     }
 
-    // add the selected talon set to info states
-    AppendToAllInformationStates(absl::StrCat(action_id, ";"));
-
-    std::sort(player_cards.begin(), player_cards.end());
-    talon_.erase(talon_.begin() + set_begin, talon_.begin() + set_end);
+    for (int i = set_begin; i < set_end; i++) {
+      data_.talon_positions &= ~(1 << i);
+    }
   } else {
     // discarding the cards
-    MoveActionFromTo(action_id, &player_cards,
-                     &players_collected_cards_.at(current_player_));
+    player_cards &= ~CardActionToCardSet(action_id);
+    data_.players_collected_cards.at(data_.current_player) |=
+        CardActionToCardSet(action_id);
+    public_inferences_.discarded_cards |= CardActionToCardSet(action_id);
 
-    // note that all players see discarded tarok cards but only the discarder
-    // knows about discarded non-taroks
-    if (player_cards.size() == 48 / num_players_) {
+    if (CardSetSize(player_cards) == 48 / kNumPlayers) {
       // talon exchange phase is finished
-      if (ActionToCard(action_id).suit == CardSuit::kTaroks)
-        AppendToAllInformationStates(absl::StrCat(action_id, ";"));
-      else
-        AppendToInformationState(current_player_, absl::StrCat(action_id, ";"));
       StartTricksPlayingPhase();
-    } else {
-      // talon exchange phase will continue
-      if (ActionToCard(action_id).suit == CardSuit::kTaroks)
-        AppendToAllInformationStates(absl::StrCat(action_id, ","));
-      else
-        AppendToInformationState(current_player_, absl::StrCat(action_id, ","));
     }
   }
 }
 
 void TarokState::StartTricksPlayingPhase() {
-  current_game_phase_ = GamePhase::kTricksPlaying;
-  if (selected_contract_->declarer_starts)
-    current_player_ = declarer_;
+  data_.current_game_phase = GamePhase::kTricksPlaying;
+  if (SelectedContract().declarer_starts)
+    data_.current_player = data_.declarer;
   else
-    current_player_ = 0;
+    data_.current_player = 0;
 }
 
+template <int kNumPlayers>
 void TarokState::DoApplyActionInTricksPlaying(open_spiel::Action action_id) {
-  MoveActionFromTo(action_id, &players_cards_.at(current_player_),
-                   &trick_cards_);
-  AppendToAllInformationStates(std::to_string(action_id));
-  if (trick_cards_.size() == num_players_) {
-    ResolveTrick();
-    if (players_cards_.at(current_player_).empty() ||
-        ((selected_contract_->name == ContractName::kBeggar ||
-          selected_contract_->name == ContractName::kOpenBeggar) &&
-         current_player_ == declarer_) ||
-        ((selected_contract_->name == ContractName::kColourValatWithout ||
-          selected_contract_->name == ContractName::kValatWithout) &&
-         current_player_ != declarer_)) {
-      current_game_phase_ = GamePhase::kFinished;
-    } else {
-      AppendToAllInformationStates(";");
+  CardSet& trick_excluded_cards =
+      public_inferences_.players_trick_excluded_cards.at(data_.current_player);
+  CardSet added_excluded_cards =
+      InferExcludedCards(action_id) & ~trick_excluded_cards;
+  trick_excluded_cards |= added_excluded_cards;
+  public_inferences_.added_trick_excluded_cards.at(NumCardsPlayedInTricks()) =
+      added_excluded_cards;
+
+  CardSet card = CardActionToCardSet(action_id);
+  for (int i = 0; i < kNumPlayers; i++) ExcludeCardsPublicly(i, card);
+  ExcludeCardsPublicly(data_.current_player, added_excluded_cards);
+  data_.players_cards.at(data_.current_player) &= ~card;
+  data_.players_played_cards.at(data_.current_player) |= card;
+  AddTrickCard(action_id);
+  if (data_.trick_cards.size() == kNumPlayers) {
+    ResolveTrick<kNumPlayers>();
+    if (data_.players_cards.at(data_.current_player) == kEmptyCardSet ||
+        ((SelectedContract().name == ContractName::kBeggar ||
+          SelectedContract().name == ContractName::kOpenBeggar) &&
+         data_.current_player == data_.declarer) ||
+        ((SelectedContract().name == ContractName::kColourValatWithout ||
+          SelectedContract().name == ContractName::kValatWithout) &&
+         data_.current_player != data_.declarer)) {
+      data_.current_game_phase = GamePhase::kFinished;
     }
   } else {
-    NextPlayer();
-    AppendToAllInformationStates(",");
+    NextPlayer<kNumPlayers>();
   }
 }
 
-void TarokState::ResolveTrick() {
-  auto [trick_winner, winning_action] = ResolveTrickWinnerAndWinningAction();
-  auto& trick_winner_collected_cards =
-      players_collected_cards_.at(trick_winner);
+CardSet TarokState::ComputePubliclyExcludedCards(
+    open_spiel::Player player) const {
+  CardSet excluded_cards =
+      public_inferences_.players_trick_excluded_cards.at(player);
+  for (int i = 0; i < num_players_; i++)
+    excluded_cards |= data_.players_played_cards.at(i);
+
+  CardSet talon_cards = kEmptyCardSet;
+  for (auto const& action : data_.talon)
+    talon_cards |= CardActionToCardSet(action);
+  CardSet selected_talon_set = public_inferences_.selected_talon_set;
+  CardSet discarded_cards = public_inferences_.discarded_cards;
+  if (data_.current_game_phase == GamePhase::kTalonExchange ||
+      (data_.current_game_phase > GamePhase::kTalonExchange &&
+       SelectedContract().NeedsTalonExchange())) {
+    // the talon is shown to all players, only the declarer takes cards from it
+    if (player == data_.declarer) talon_cards &= ~selected_talon_set;
+    excluded_cards |= talon_cards;
+  } else if (data_.current_game_phase > GamePhase::kTalonExchange) {
+    // talon cards are shown one by one as they are gifted in klop
+    excluded_cards |= talon_cards & ~TalonCardSet();
+  }
+
+  CardSet taroks = SuitToCardSet(CardSuit::kTaroks);
+  excluded_cards |= discarded_cards & taroks;
+  if (player == data_.declarer && (discarded_cards & taroks)) {
+    // taroks can only be discarded by a declarer without other cards that can
+    // be discarded
+    excluded_cards |= kFullCardSet & ~taroks & ~kKingsCardSet;
+  }
+  return excluded_cards;
+}
 
-  for (auto const& action : trick_cards_) {
-    trick_winner_collected_cards.push_back(action);
+void TarokState::UpdatePubliclyExcludedCards() {
+  for (int i = 0; i < num_players_; i++) {
+    CardSet excluded_cards = ComputePubliclyExcludedCards(i);
+    CardSet& previous_excluded_cards =
+        public_inferences_.players_excluded_cards.at(i);
+    // only the holders of cards that changed are updated
+    for (CardSet cards = excluded_cards ^ previous_excluded_cards;
+         cards != kEmptyCardSet; cards &= cards - 1) {
+      public_inferences_.possible_card_holders.at(LowestCardAction(cards)) ^=
+          1 << i;
+    }
+    previous_excluded_cards = excluded_cards;
+  }
+}
+
+void TarokState::ExcludeCardsPublicly(open_spiel::Player player,
+                                      CardSet cards) {
+  CardSet& excluded_cards =
+      public_inferences_.players_excluded_cards.at(player);
+  for (CardSet added_cards = cards & ~excluded_cards;
+       added_cards != kEmptyCardSet; added_cards &= added_cards - 1) {
+    public_inferences_.possible_card_holders.at(
+        LowestCardAction(added_cards)) &= ~(1 << player);
+  }
+  excluded_cards |= cards;
+}
+
+CardSet TarokState::InferExcludedCards(open_spiel::Action action_id) const {
+  if (data_.trick_cards.empty()) return kEmptyCardSet;
+  CardSet taroks = SuitToCardSet(CardSuit::kTaroks);
+  CardSuit suit = CardActionSuit(action_id);
+  CardSuit opening_suit = CardActionSuit(data_.trick_cards.front());
+  CardSet excluded_cards = kEmptyCardSet;
+  if (suit != opening_suit) {
+    excluded_cards |= SuitToCardSet(opening_suit);
+    // any card can be played without the opening suit and taroks
+    if (suit != CardSuit::kTaroks) return excluded_cards | taroks;
+  }
+  if (!SelectedContract().is_negative) return excluded_cards;
+
+  // the suit that had to be played is the suit of the played card from here
+  // on, see LegalTrickCards()
+  if ((TrickCardSet() & kMondAndSkisCardSet) == kMondAndSkisCardSet) {
+    // pagat has to be played in the emperor trick
+    if (action_id == kPagatAction) return excluded_cards;
+    excluded_cards |= CardActionToCardSet(kPagatAction);
   }
+  auto action_to_beat =
+      ActionToBeatInNegativeContracts(data_.trick_cards, suit);
+  if (action_to_beat && action_id < *action_to_beat) {
+    // the player has no higher cards of the suit
+    excluded_cards |=
+        SuitToCardSet(suit) & ~(CardActionToCardSet(*action_to_beat + 1) - 1);
+  }
+  if (action_id == kPagatAction) {
+    // pagat is only played when it's the only card that can be played
+    excluded_cards |= taroks & ~CardActionToCardSet(kPagatAction);
+  }
+  return excluded_cards;
+}
 
-  if (selected_contract_->name == ContractName::kKlop && talon_.size() > 0) {
-    // add the "gift" talon card in klop
-    trick_winner_collected_cards.push_back(talon_.front());
-    AppendToAllInformationStates(absl::StrCat(",", talon_.front()));
-    talon_.erase(talon_.begin());
-  } else if (winning_action == called_king_ && called_king_in_talon_) {
+template <int kNumPlayers>
+void TarokState::ResolveTrick() {
+  auto [trick_winner, winning_action] =
+      ResolveTrickWinnerAndWinningAction<kNumPlayers>();
+  CardSet& trick_winner_collected_cards =
+      data_.players_collected_cards.at(trick_winner);
+
+  std::copy(data_.trick_cards.begin(), data_.trick_cards.end(),
+            data_.last_trick_cards.begin());
+  trick_winner_collected_cards |= TrickCardSet();
+
+  if (SelectedContract().name == ContractName::kKlop && TalonSize() > 0) {
+    // add the "gift" talon card in klop, talon cards are gifted from left to
+    // right
+    int gift_position = __builtin_ctz(data_.talon_positions);
+    open_spiel::Action gift_action = data_.talon.at(gift_position);
+    trick_winner_collected_cards |= CardActionToCardSet(gift_action);
+    data_.talon_positions &= ~(1 << gift_position);
+    for (int i = 0; i < kNumPlayers; i++)
+      ExcludeCardsPublicly(i, CardActionToCardSet(gift_action));
+  } else if (winning_action == data_.called_king &&
+             data_.called_king_in_talon) {
     // declearer won the trick with the called king that was in talon so all
     // of the talon cards belong to the declearer (note that this is only
     // possible when talon exchange actually happened in the past)
-    bool mond_in_talon = false;
-    for (auto const& action : talon_) {
-      trick_winner_collected_cards.push_back(action);
-      if (action == kMondAction) mond_in_talon = true;
-    }
-    if (mond_in_talon) {
+    CardSet talon_cards = TalonCardSet();
+    trick_winner_collected_cards |= talon_cards;
+    if (CardActionInCardSet(kMondAction, talon_cards)) {
       // the called king and mond were in different parts of the talon and
       // declearer selected the set with the king plus won the mond as
       // part of the obtained talon remainder, negating the captured mond
       // penalty obtained during DoApplyActionInTalonExchange()
-      captured_mond_player_ = open_spiel::kInvalidPlayer;
+      data_.captured_mond_player = open_spiel::kInvalidPlayer;
     }
-    talon_.clear();
-  } else if ((selected_contract_->NeedsTalonExchange() ||
-              selected_contract_->name == ContractName::kSoloWithout) &&
+    data_.talon_positions = 0;
+  } else if ((SelectedContract().NeedsTalonExchange() ||
+              SelectedContract().name == ContractName::kSoloWithout) &&
              (winning_action == kSkisAction ||
               winning_action == kPagatAction)) {
     // check if mond is captured by skis or pagat (emperor's trick) and
     // penalise the player of the mond in certain contracts
-    for (int i = 0; i < trick_cards_.size(); i++) {
-      if (trick_cards_.at(i) == kMondAction) {
-        captured_mond_player_ = TrickCardsIndexToPlayer(i);
+    for (int i = 0; i < data_.trick_cards.size(); i++) {
+      if (data_.trick_cards.at(i) == kMondAction) {
+        data_.captured_mond_player = TrickCardsIndexToPlayer<kNumPlayers>(i);
       }
     }
   }
 
-  trick_cards_.clear();
-  current_player_ = trick_winner;
+  data_.trick_cards.clear();
+  data_.current_player = trick_winner;
 }
 
+void TarokState::AddTrickCard(open_spiel::Action action_id) {
+  data_.trick_cards.push_back(action_id);
+  int index = data_.trick_cards.size() - 1;
+  winning_trick_cards_indices_[index] =
+      index == 0 ? 0
+                 : NextWinningTrickCardsIndex(
+                       data_.trick_cards, index,
+                       winning_trick_cards_indices_[index - 1],
+                       TaroksAreTrumps());
+}
+
+template <int kNumPlayers>
 TrickWinnerAndAction TarokState::ResolveTrickWinnerAndWinningAction() const {
-  // compute the winning action index within trick_cards_
-  int winning_action_i;
-  if ((ActionInActions(kPagatAction, trick_cards_) &&
-       ActionInActions(kMondAction, trick_cards_) &&
-       ActionInActions(kSkisAction, trick_cards_)) &&
-      (selected_contract_->name != ContractName::kColourValatWithout ||
-       ActionToCard(trick_cards_.front()).suit == CardSuit::kTaroks)) {
-    // the emperor trick, i.e. pagat wins over mond and skis in all cases but
-    // not in Contract::kColourValatWithout when a non-trump is led
+  int winning_action_i =
+      winning_trick_cards_indices_.at(data_.trick_cards.size() - 1);
+  return {TrickCardsIndexToPlayer<kNumPlayers>(winning_action_i),
+          data_.trick_cards.at(winning_action_i)};
+}
+
+int TarokState::WinningTrickCardsIndex(
+    const CardActions<4>& trick_cards) const {
+  int winning_action_i = 0;
+  for (int i = 1; i < trick_cards.size(); i++)
     winning_action_i =
-        std::find(trick_cards_.begin(), trick_cards_.end(), kPagatAction) -
-        trick_cards_.begin();
-  } else {
-    winning_action_i = 0;
-    for (int i = 1; i < trick_cards_.size(); i++) {
-      const Card& winning_card =
-          ActionToCard(trick_cards_.at(winning_action_i));
-      const Card& current_card = ActionToCard(trick_cards_.at(i));
-
-      if (((current_card.suit == CardSuit::kTaroks &&
-            selected_contract_->name != ContractName::kColourValatWithout) ||
-           current_card.suit == winning_card.suit) &&
-          current_card.rank > winning_card.rank) {
-        winning_action_i = i;
-      }
-    }
+        NextWinningTrickCardsIndex(trick_cards, i, winning_action_i,
+                                   TaroksAreTrumps());
+  return winning_action_i;
+}
+
+bool TarokState::TaroksAreTrumps() const {
+  return SelectedContract().name != ContractName::kColourValatWithout;
+}
+
+int TarokState::NumCardsPlayedInTricks() const {
+  if (data_.current_game_phase != GamePhase::kTricksPlaying &&
+      data_.current_game_phase != GamePhase::kFinished) {
+    return 0;
+  }
+  // all players hold the same number of cards when the tricks playing phase
+  // starts
+  int num_cards = 48;
+  for (auto const& player_cards : data_.players_cards) {
+    num_cards -= CardSetSize(player_cards);
   }
-  return {TrickCardsIndexToPlayer(winning_action_i),
-          trick_cards_.at(winning_action_i)};
+  return num_cards;
 }
 
+template <int kNumPlayers>
 open_spiel::Player TarokState::TrickCardsIndexToPlayer(int index) const {
-  open_spiel::Player player = current_player_;
-  for (int i = 0; i < trick_cards_.size() - 1 - index; i++) {
-    player -= 1;
-    if (player == -1) player = num_players_ - 1;
-  }
-  return player;
+  // the current player played the last of the trick cards
+  int num_later_cards = data_.trick_cards.size() - 1 - index;
+  return (data_.current_player - num_later_cards + kNumPlayers) % kNumPlayers;
 }
 
 std::vector<double> TarokState::Returns() const {
   std::vector<double> returns(num_players_, 0.0);
   if (!IsTerminal()) return returns;
 
-  std::vector<int> penalties = CapturedMondPenalties();
-  std::vector<int> scores = ScoresWithoutCapturedMondPenalties();
-  for (int i = 0; i < num_players_; i++) {
-    returns.at(i) = penalties.at(i) + scores.at(i);
-  }
+  std::array<int, 4> scores = Scores();
+  for (int i = 0; i < num_players_; i++) returns[i] = scores[i];
+  if (data_.captured_mond_player != open_spiel::kInvalidPlayer)
+    returns[data_.captured_mond_player] -= 20;
   return returns;
 }
 
 std::vector<int> TarokState::CapturedMondPenalties() const {
   std::vector<int> penalties(num_players_, 0);
-  if (captured_mond_player_ != open_spiel::kInvalidPlayer)
-    penalties.at(captured_mond_player_) = -20;
+  if (data_.captured_mond_player != open_spiel::kInvalidPlayer)
+    penalties.at(data_.captured_mond_player) = -20;
   return penalties;
 }
 
 std::vector<int> TarokState::ScoresWithoutCapturedMondPenalties() const {
   if (!IsTerminal()) return std::vector<int>(num_players_, 0);
-  if (selected_contract_->name == ContractName::kKlop) {
+  std::array<int, 4> scores = Scores();
+  return std::vector<int>(scores.begin(), scores.begin() + num_players_);
+}
+
+std::array<int, 4> TarokState::Scores() const {
+  if (SelectedContract().name == ContractName::kKlop) {
     return ScoresInKlop();
-  } else if (selected_contract_->NeedsTalonExchange()) {
+  } else if (SelectedContract().NeedsTalonExchange()) {
     return ScoresInNormalContracts();
   } else {
     // beggar and above
@@ -656,42 +998,39 @@ std::vector<int> TarokState::ScoresWithoutCapturedMondPenalties() const {
   }
 }
 
-std::vector<int> TarokState::ScoresInKlop() const {
-  std::vector<int> scores;
-  scores.reserve(num_players_);
-
+std::array<int, 4> TarokState::ScoresInKlop() const {
+  std::array<int, 4> scores{};
   bool any_player_won_or_lost = false;
   for (int i = 0; i < num_players_; i++) {
-    int points = CardPoints(players_collected_cards_.at(i),
-                            tarok_parent_game_->card_deck_);
+    int points = CardPoints(data_.players_collected_cards[i]);
     if (points > 35) {
       any_player_won_or_lost = true;
-      scores.push_back(-70);
+      scores[i] = -70;
     } else if (points == 0) {
       any_player_won_or_lost = true;
-      scores.push_back(70);
+      scores[i] = 70;
     } else {
-      scores.push_back(-points);
+      scores[i] = -points;
     }
   }
   if (any_player_won_or_lost) {
     // only the winners and losers score
     for (int i = 0; i < num_players_; i++) {
-      if (std::abs(scores.at(i)) != 70) scores.at(i) = 0;
+      if (std::abs(scores[i]) != 70) scores[i] = 0;
     }
   }
   return scores;
 }
 
-std::vector<int> TarokState::ScoresInNormalContracts() const {
+std::array<int, 4> TarokState::ScoresInNormalContracts() const {
   auto [collected_cards, opposite_collected_cards] =
       SplitCollectedCardsPerTeams();
   // calculate bonuses
   int bonuses;
-  if (collected_cards.size() == 48) {
+  if (CardSetSize(collected_cards) == 48) {
     // valat won
     bonuses = 250;
-  } else if (opposite_collected_cards.size() == 48) {
+  } else if (CardSetSize(opposite_collected_cards) == 48) {
     // valat lost
     bonuses = -250;
   } else {
@@ -699,61 +1038,51 @@ std::vector<int> TarokState::ScoresInNormalContracts() const {
     bonuses = NonValatBonuses(collected_cards, opposite_collected_cards);
   }
   // calculate final scores
-  int card_points = CardPoints(collected_cards, tarok_parent_game_->card_deck_);
+  int card_points = CardPoints(collected_cards);
   int score = card_points - 35;
   if (card_points > 35)
-    score += selected_contract_->score;
+    score += SelectedContract().score;
   else
-    score -= selected_contract_->score;
+    score -= SelectedContract().score;
   score += bonuses;
 
-  std::vector<int> scores(num_players_, 0);
-  scores.at(declarer_) = score;
-  if (declarer_partner_ != open_spiel::kInvalidPlayer)
-    scores.at(declarer_partner_) = score;
+  std::array<int, 4> scores{};
+  scores[data_.declarer] = score;
+  if (data_.declarer_partner != open_spiel::kInvalidPlayer)
+    scores[data_.declarer_partner] = score;
   return scores;
 }
 
 CollectedCardsPerTeam TarokState::SplitCollectedCardsPerTeams() const {
-  std::vector<open_spiel::Action> collected_cards =
-      players_collected_cards_.at(declarer_);
-  std::vector<open_spiel::Action> opposite_collected_cards;
+  CardSet collected_cards = data_.players_collected_cards.at(data_.declarer);
+  CardSet opposite_collected_cards = kEmptyCardSet;
   for (open_spiel::Player p = 0; p < num_players_; p++) {
-    if (p != declarer_ && p != declarer_partner_) {
-      opposite_collected_cards.insert(opposite_collected_cards.end(),
-                                      players_collected_cards_.at(p).begin(),
-                                      players_collected_cards_.at(p).end());
-    } else if (p == declarer_partner_) {
-      collected_cards.insert(collected_cards.end(),
-                             players_collected_cards_.at(p).begin(),
-                             players_collected_cards_.at(p).end());
+    if (p != data_.declarer && p != data_.declarer_partner) {
+      opposite_collected_cards |= data_.players_collected_cards.at(p);
+    } else if (p == data_.declarer_partner) {
+      collected_cards |= data_.players_collected_cards.at(p);
     }
   }
   return {collected_cards, opposite_collected_cards};
 }
 
-int TarokState::NonValatBonuses(
-    const std::vector<open_spiel::Action>& collected_cards,
-    const std::vector<open_spiel::Action>& opposite_collected_cards) const {
+int TarokState::NonValatBonuses(CardSet collected_cards,
+                                CardSet opposite_collected_cards) const {
   int bonuses = 0;
-  // last trick winner is the current player
-  auto const& last_trick_winner_cards =
-      players_collected_cards_.at(current_player_);
-  // king ultimo and pagat ultimo
+  // king ultimo and pagat ultimo, note that the last trick winner is the
+  // current player
   int ultimo_bonus = 0;
-  if (std::find(last_trick_winner_cards.end() - num_players_,
-                last_trick_winner_cards.end(),
-                called_king_) != last_trick_winner_cards.end()) {
+  if (data_.called_king != open_spiel::kInvalidAction &&
+      CardActionInCardSet(data_.called_king, LastTrickCardSet())) {
     // king ultimo
     ultimo_bonus = 10;
-  } else if (std::find(last_trick_winner_cards.end() - num_players_,
-                       last_trick_winner_cards.end(),
-                       0) != last_trick_winner_cards.end()) {
+  } else if (CardActionInCardSet(kPagatAction, LastTrickCardSet())) {
     // pagat ultimo
     ultimo_bonus = 25;
   }
   if (ultimo_bonus > 0 &&
-      (current_player_ == declarer_ || current_player_ == declarer_partner_)) {
+      (data_.current_player == data_.declarer ||
+       data_.current_player == data_.declarer_partner)) {
     bonuses = ultimo_bonus;
   } else if (ultimo_bonus > 0) {
     bonuses = -ultimo_bonus;
@@ -776,39 +1105,32 @@ int TarokState::NonValatBonuses(
 }
 
 std::tuple<bool, bool> TarokState::CollectedKingsAndOrTrula(
-    const std::vector<open_spiel::Action>& collected_cards) const {
-  int num_kings = 0, num_trula = 0;
-  for (auto const& action : collected_cards) {
-    if (action == kKingOfHeartsAction || kKingOfDiamondsAction == 37 ||
-        action == kKingOfSpadesAction || kKingOfClubsAction == 53) {
-      num_kings += 1;
-    } else if (action == kPagatAction || action == kMondAction ||
-               action == kSkisAction) {
-      num_trula += 1;
-    }
-  }
-  return {num_kings == 4, num_trula == 3};
+    CardSet collected_cards) const {
+  return {(collected_cards & kKingsCardSet) == kKingsCardSet,
+          (collected_cards & kTrulaCardSet) == kTrulaCardSet};
 }
 
-std::vector<int> TarokState::ScoresInHigherContracts() const {
+std::array<int, 4> TarokState::ScoresInHigherContracts() const {
   bool declarer_won;
-  if (selected_contract_->name == ContractName::kBeggar ||
-      selected_contract_->name == ContractName::kOpenBeggar) {
-    declarer_won = players_collected_cards_.at(declarer_).size() == 0;
-  } else if (selected_contract_->name == ContractName::kColourValatWithout ||
-             selected_contract_->name == ContractName::kValatWithout) {
-    declarer_won = players_collected_cards_.at(declarer_).size() == 48;
+  if (SelectedContract().name == ContractName::kBeggar ||
+      SelectedContract().name == ContractName::kOpenBeggar) {
+    declarer_won =
+        data_.players_collected_cards.at(data_.declarer) == kEmptyCardSet;
+  } else if (SelectedContract().name == ContractName::kColourValatWithout ||
+             SelectedContract().name == ContractName::kValatWithout) {
+    declarer_won =
+        CardSetSize(data_.players_collected_cards.at(data_.declarer)) == 48;
   } else {
     // solo without
-    declarer_won = CardPoints(players_collected_cards_.at(declarer_),
-                              tarok_parent_game_->card_deck_) > 35;
+    declarer_won =
+        CardPoints(data_.players_collected_cards.at(data_.declarer)) > 35;
   }
 
-  std::vector<int> scores(num_players_, 0);
+  std::array<int, 4> scores{};
   if (declarer_won)
-    scores.at(declarer_) = selected_contract_->score;
+    scores[data_.declarer] = SelectedContract().score;
   else
-    scores.at(declarer_) = -selected_contract_->score;
+    scores[data_.declarer] = -SelectedContract().score;
   return scores;
 }
 
@@ -816,7 +1138,251 @@ std::string TarokState::InformationStateString(
     open_spiel::Player player) const {
   SPIEL_CHECK_GE(player, 0);
   SPIEL_CHECK_LT(player, num_players_);
-  return players_info_states_.at(player);
+  std::string info_state;
+  if (data_.current_game_phase == GamePhase::kCardDealing) return info_state;
+
+  // info states are rendered from the dealt cards and history, the history is
+  // split into game phases from its end, i.e. cards played in tricks are the
+  // last actions and are preceded by the talon exchange actions, the called
+  // king and the bids, the deal is recovered from the current state so that
+  // states with replaced hidden cards (see DeterminizationSampler) render
+  // their own deal
+  absl::StrAppend(
+      &info_state,
+      absl::StrJoin(CardSetToActions(DealtPlayerCards(player)), ","), ";");
+  int num_played = NumCardsPlayedInTricks();
+  int played_begin = history_.size() - num_played;
+  auto [selected_talon_set, discarded_cards] =
+      SelectedTalonSetAndDiscardedCards();
+  int talon_exchange_begin = played_begin;
+  if (selected_talon_set != kEmptyCardSet)
+    talon_exchange_begin -= 1 + CardSetSize(discarded_cards);
+  int bidding_end = talon_exchange_begin;
+  if (data_.called_king != open_spiel::kInvalidAction) bidding_end--;
+
+  // the first action in history is the dummy card dealing action
+  for (int i = 1; i < bidding_end; i++) {
+    bool last_bid = i == bidding_end - 1 &&
+                    data_.current_game_phase > GamePhase::kBidding;
+    absl::StrAppend(&info_state, history_.at(i).action, last_bid ? ";" : ",");
+  }
+  if (data_.called_king != open_spiel::kInvalidAction)
+    absl::StrAppend(&info_state, data_.called_king, ";");
+  if (selected_talon_set != kEmptyCardSet) {
+    absl::StrAppend(&info_state, absl::StrJoin(data_.talon, ","), ";",
+                    history_.at(talon_exchange_begin).action, ";");
+  }
+  for (int i = talon_exchange_begin + 1; i < played_begin; i++) {
+    // all players see discarded tarok cards but only the discarder knows
+    // about discarded non-taroks
+    open_spiel::Action action_id = history_.at(i).action;
+    bool last_discard = i == played_begin - 1 &&
+                        data_.current_game_phase > GamePhase::kTalonExchange;
+    if (player == data_.declarer ||
+        CardActionSuit(action_id) == CardSuit::kTaroks) {
+      absl::StrAppend(&info_state, action_id, last_discard ? ";" : ",");
+    }
+  }
+
+  for (int i = 0; i < num_played; i++) {
+    absl::StrAppend(&info_state, history_.at(played_begin + i).action);
+    if (i % num_players_ < num_players_ - 1) {
+      absl::StrAppend(&info_state, ",");
+      continue;
+    }
+    int num_tricks = i / num_players_ + 1;
+    if (SelectedContract().name == ContractName::kKlop && num_tricks <= 6) {
+      // talon cards are gifted from left to right, one per trick
+      open_spiel::Action gift_action = data_.talon.at(num_tricks - 1);
+      absl::StrAppend(&info_state, ",", gift_action);
+    }
+    if (i < num_played - 1 ||
+        data_.current_game_phase != GamePhase::kFinished) {
+      absl::StrAppend(&info_state, ";");
+    }
+  }
+  return info_state;
+}
+
+uint64_t TarokState::InformationStateKey(open_spiel::Player player) const {
+  SPIEL_CHECK_GE(player, 0);
+  SPIEL_CHECK_LT(player, num_players_);
+  return information_state_keys_.keys[player];
+}
+
+std::tuple<CardSet, CardSet> TarokState::SelectedTalonSetAndDiscardedCards()
+    const {
+  return {public_inferences_.selected_talon_set,
+          public_inferences_.discarded_cards};
+}
+
+CardSet TarokState::DealtPlayerCards(open_spiel::Player player) const {
+  // dealt cards are recovered from the current and played ones instead of
+  // dealing them again, the declarer additionally exchanged the talon
+  CardSet dealt_cards = data_.players_cards.at(player) |
+                        data_.players_played_cards.at(player);
+  if (player == data_.declarer) {
+    auto [selected_talon_set, discarded_cards] =
+        SelectedTalonSetAndDiscardedCards();
+    dealt_cards = (dealt_cards | discarded_cards) & ~selected_talon_set;
+  }
+  return dealt_cards;
+}
+
+// sets values at card action indices of the cards in the set
+static void EncodeCardSet(CardSet cards, absl::Span<float> values) {
+  for (; cards != kEmptyCardSet; cards &= cards - 1) {
+    values.at(LowestCardAction(cards)) = 1;
+  }
+}
+
+void TarokState::InformationStateTensor(open_spiel::Player player,
+                                        absl::Span<float> values) const {
+  SPIEL_CHECK_GE(player, 0);
+  SPIEL_CHECK_LT(player, num_players_);
+  SPIEL_CHECK_EQ(values.size(),
+                 tarok_parent_game_->InformationStateTensorShape().front());
+  std::fill(values.begin(), values.end(), 0);
+  if (data_.current_game_phase == GamePhase::kCardDealing) return;
+
+  int offset = 0;
+  values.at(player) = 1;
+  offset += num_players_;
+  // dealt cards are encoded once the talon exchange is known
+  int dealt_cards_offset = offset;
+  offset += 54;
+
+  for (int i = 0; i < num_players_; i++) {
+    if (data_.players_bids.at(i) != kInvalidBidAction)
+      values.at(offset + data_.players_bids.at(i)) = 1;
+    offset += 13;
+  }
+
+  if (data_.called_king != open_spiel::kInvalidAction) {
+    // kings are the last cards of each colour suit
+    values.at(offset + (data_.called_king - kKingOfHeartsAction) / 8) = 1;
+  }
+  offset += 4;
+
+  CardSet dealt_talon = kEmptyCardSet;
+  for (auto const& action : data_.talon) {
+    dealt_talon |= CardActionToCardSet(action);
+  }
+  CardSet shown_talon = kEmptyCardSet;
+  auto [selected_talon_set, discarded_cards] =
+      SelectedTalonSetAndDiscardedCards();
+  // all players see discarded taroks but only the declarer knows about
+  // discarded non-taroks
+  if (player != data_.declarer)
+    discarded_cards &= SuitToCardSet(CardSuit::kTaroks);
+  if (data_.current_game_phase == GamePhase::kTalonExchange ||
+      (data_.current_game_phase > GamePhase::kTalonExchange &&
+       SelectedContract().NeedsTalonExchange())) {
+    shown_talon = dealt_talon;
+  } else if (data_.current_game_phase > GamePhase::kTalonExchange &&
+             SelectedContract().name == ContractName::kKlop) {
+    // talon cards are gifted to trick winners one by one
+    shown_talon = dealt_talon & ~TalonCardSet();
+  }
+  EncodeCardSet(shown_talon, values.subspan(offset, 54));
+  offset += 54;
+  CardSet dealt_cards = DealtPlayerCards(player);
+  EncodeCardSet(dealt_cards, values.subspan(dealt_cards_offset, 54));
+  EncodeCardSet(selected_talon_set, values.subspan(offset, 54));
+  offset += 54;
+  EncodeCardSet(discarded_cards, values.subspan(offset, 54));
+  offset += 54;
+
+  // cards played in tricks are the last actions in history
+  int num_played = NumCardsPlayedInTricks();
+  int played_begin = history_.size() - num_played;
+  open_spiel::Player trick_opener = 0;
+  if (num_played > 0 && SelectedContract().declarer_starts)
+    trick_opener = data_.declarer;
+  CardActions<4> trick_cards;
+  for (int i = 0; i < num_played; i++) {
+    int trick_index = i % num_players_;
+    if (trick_index == 0) values.at(offset + trick_opener) = 1;
+    open_spiel::Player trick_player =
+        (trick_opener + trick_index) % num_players_;
+    trick_cards.push_back(history_.at(played_begin + i).action);
+    values.at(offset + num_players_ + trick_player * 54 +
+              trick_cards.at(trick_index)) = 1;
+    if (trick_index == num_players_ - 1) {
+      // the next trick is opened by the winner of this one
+      offset += num_players_ + num_players_ * 54;
+      trick_opener =
+          (trick_opener + WinningTrickCardsIndex(trick_cards)) % num_players_;
+      trick_cards.clear();
+    }
+  }
+}
+
+void TarokState::ObservationTensor(open_spiel::Player player,
+                                   absl::Span<float> values) const {
+  SPIEL_CHECK_GE(player, 0);
+  SPIEL_CHECK_LT(player, num_players_);
+  SPIEL_CHECK_EQ(values.size(),
+                 tarok_parent_game_->ObservationTensorShape().front());
+  std::fill(values.begin(), values.end(), 0);
+  if (data_.current_game_phase == GamePhase::kCardDealing) return;
+
+  auto relative_seat = [this, player](open_spiel::Player other) {
+    return (other - player + num_players_) % num_players_;
+  };
+
+  int offset = 0;
+  EncodeCardSet(data_.players_cards.at(player), values.subspan(offset, 54));
+  offset += 54;
+
+  for (int i = 0; i < num_players_; i++) {
+    if (data_.players_bids.at(i) != kInvalidBidAction)
+      values.at(offset + relative_seat(i) * 13 + data_.players_bids.at(i)) = 1;
+  }
+  offset += num_players_ * 13;
+
+  ContractName contract_name = SelectedContractName();
+  if (contract_name != ContractName::kNotSelected)
+    values.at(offset + static_cast<int>(contract_name)) = 1;
+  offset += 12;
+
+  if (data_.declarer != open_spiel::kInvalidPlayer)
+    values.at(offset + relative_seat(data_.declarer)) = 1;
+  offset += num_players_;
+
+  // the partner is revealed by playing the called king, the partner knows
+  // about it from the start
+  if (data_.declarer_partner != open_spiel::kInvalidPlayer &&
+      (player == data_.declarer_partner ||
+       CardActionInCardSet(
+           data_.called_king,
+           data_.players_played_cards.at(data_.declarer_partner)))) {
+    values.at(offset) = 1;
+    values.at(offset + 1 + relative_seat(data_.declarer_partner)) = 1;
+  }
+  offset += 1 + num_players_;
+
+  // the current player is the next one to play in an unfinished trick
+  int num_trick_cards = data_.trick_cards.size();
+  for (int i = 0; i < num_trick_cards; i++) {
+    open_spiel::Player trick_player =
+        (data_.current_player - num_trick_cards + i + num_players_) %
+        num_players_;
+    values.at(offset + relative_seat(trick_player) * 54 +
+              data_.trick_cards.at(i)) = 1;
+  }
+  offset += num_players_ * 54;
+
+  for (int i = 0; i < num_players_; i++) {
+    EncodeCardSet(data_.players_played_cards.at(i),
+                  values.subspan(offset + relative_seat(i) * 54, 54));
+  }
+  offset += num_players_ * 54;
+
+  for (int i = 0; i < num_players_; i++) {
+    values.at(offset + relative_seat(i)) =
+        CardPoints(data_.players_collected_cards.at(i)) / 70.0;
+  }
 }
 
 std::string TarokState::ToString() const {
@@ -851,41 +1417,254 @@ std::string TarokState::ToString() const {
   return str;
 }
 
+bool TarokState::operator==(const TarokState& other) const {
+  auto position = [](const TarokStateData& data) {
+    return std::tie(data.players_cards, data.players_collected_cards,
+                    data.players_played_cards, data.current_game_phase,
+                    data.current_player, data.talon, data.talon_positions,
+                    data.trick_cards, data.last_trick_cards, data.players_bids,
+                    data.declarer, data.selected_contract, data.called_king,
+                    data.called_king_in_talon, data.declarer_partner,
+                    data.captured_mond_player);
+  };
+  return hash_ == other.hash_ && num_players_ == other.num_players_ &&
+         position(data_) == position(other.data_);
+}
+
+bool TarokState::operator!=(const TarokState& other) const {
+  return !(*this == other);
+}
+
+uint64_t TarokState::Hash() const { return hash_; }
+
 std::unique_ptr<open_spiel::State> TarokState::Clone() const {
   return std::unique_ptr<open_spiel::State>(new TarokState(*this));
 }
 
+void TarokState::UndoAction(open_spiel::Player player,
+                            open_spiel::Action action_id) {
+  SPIEL_CHECK_FALSE(history_.empty());
+  SPIEL_CHECK_EQ(history_.back().player, player);
+  SPIEL_CHECK_EQ(history_.back().action, action_id);
+  if (num_players_ == 3)
+    DoUndoAction<3>(player, action_id);
+  else
+    DoUndoAction<4>(player, action_id);
+  history_.pop_back();
+  --move_number_;
+}
+
+template <int kNumPlayers>
+void TarokState::DoUndoAction(open_spiel::Player player,
+                              open_spiel::Action action_id) {
+  const TarokStateData previous_data = data_;
+
+  // the game phase in which the action was applied is deduced from the current
+  // game phase and the progress within it
+  switch (data_.current_game_phase) {
+    case GamePhase::kCardDealing:
+      open_spiel::SpielFatalError("Calling UndoAction in the initial state.");
+    case GamePhase::kBidding:
+      if (history_.size() == 1) {
+        data_ = TarokStateData{};
+        data_.deal_seed = previous_data.deal_seed;
+      } else {
+        UndoActionInBidding(player);
+      }
+      break;
+    case GamePhase::kKingCalling:
+      UndoActionInBidding(player);
+      break;
+    case GamePhase::kTalonExchange:
+      if (TalonSize() < 6)
+        UndoActionInTalonExchange<kNumPlayers>(player, action_id);
+      else if (data_.called_king != open_spiel::kInvalidAction)
+        UndoActionInKingCalling(player);
+      else
+        UndoActionInBidding(player);
+      break;
+    case GamePhase::kTricksPlaying:
+    case GamePhase::kFinished:
+      if (NumCardsPlayedInTricks() > 0)
+        UndoActionInTricksPlaying<kNumPlayers>(player, action_id);
+      else if (SelectedContract().NeedsTalonExchange())
+        UndoActionInTalonExchange<kNumPlayers>(player, action_id);
+      else
+        UndoActionInBidding(player);
+      break;
+  }
+  UpdatePubliclyExcludedCards();
+  UpdateHash<kNumPlayers>(previous_data);
+  if (data_.current_game_phase == GamePhase::kCardDealing)
+    information_state_keys_ = InformationStateKeys{};
+  else
+    UpdateInformationStateKeys<kNumPlayers>(action_id, true);
+}
+
+void TarokState::UndoActionInBidding(open_spiel::Player player) {
+  // the previous bid of the player is the last one in history before the
+  // undone bid, note that the first action in history is the dummy card
+  // dealing action
+  open_spiel::Action previous_bid = kInvalidBidAction;
+  for (int i = history_.size() - 2; i >= 1; i--) {
+    if (history_.at(i).player == player) {
+      previous_bid = history_.at(i).action;
+      break;
+    }
+  }
+  data_.players_bids.at(player) = previous_bid;
+  data_.declarer = open_spiel::kInvalidPlayer;
+  data_.selected_contract = -1;
+  data_.current_game_phase = GamePhase::kBidding;
+  data_.current_player = player;
+}
+
+void TarokState::UndoActionInKingCalling(open_spiel::Player player) {
+  data_.called_king = open_spiel::kInvalidAction;
+  data_.called_king_in_talon = false;
+  data_.declarer_partner = open_spiel::kInvalidPlayer;
+  data_.current_game_phase = GamePhase::kKingCalling;
+  data_.current_player = player;
+}
+
+template <int kNumPlayers>
+void TarokState::UndoActionInTalonExchange(open_spiel::Player player,
+                                           open_spiel::Action action_id) {
+  CardSet& player_cards = data_.players_cards.at(player);
+  int num_talon_exchanges = SelectedContract().num_talon_exchanges;
+  if (CardSetSize(player_cards) == 48 / kNumPlayers + num_talon_exchanges) {
+    // no cards were discarded yet so the talon set selection is undone, the
+    // captured mond penalty can only be obtained by selecting the talon set
+    // at this point
+    int set_begin = action_id * num_talon_exchanges;
+    for (int i = set_begin; i < set_begin + num_talon_exchanges; i++) {
+      player_cards &= ~CardActionToCardSet(data_.talon.at(i));
+      data_.talon_positions |= 1 << i;
+    }
+    data_.captured_mond_player = open_spiel::kInvalidPlayer;
+    public_inferences_.selected_talon_set = kEmptyCardSet;
+  } else {
+    player_cards |= CardActionToCardSet(action_id);
+    data_.players_collected_cards.at(player) &= ~CardActionToCardSet(action_id);
+    public_inferences_.discarded_cards &= ~CardActionToCardSet(action_id);
+  }
+  data_.current_game_phase = GamePhase::kTalonExchange;
+  data_.current_player = player;
+}
+
+template <int kNumPlayers>
+void TarokState::UndoActionInTricksPlaying(open_spiel::Player player,
+                                           open_spiel::Action action_id) {
+  // the undone card finished the trick if there are no trick cards
+  if (data_.trick_cards.empty()) UndoResolveTrick<kNumPlayers>(player);
+  data_.trick_cards.pop_back();
+  CardSet card = CardActionToCardSet(action_id);
+  data_.players_cards.at(player) |= card;
+  data_.players_played_cards.at(player) &= ~card;
+  data_.current_game_phase = GamePhase::kTricksPlaying;
+  data_.current_player = player;
+  public_inferences_.players_trick_excluded_cards.at(player) &=
+      ~public_inferences_.added_trick_excluded_cards.at(
+          NumCardsPlayedInTricks());
+}
+
+template <int kNumPlayers>
+void TarokState::UndoResolveTrick(open_spiel::Player player) {
+  // the resolved trick consists of the last actions in history, the player
+  // who finished it is set as the current player to mirror the state in
+  // which the trick was resolved
+  int num_played = NumCardsPlayedInTricks();
+  int num_tricks = num_played / kNumPlayers;
+  for (size_t i = history_.size() - kNumPlayers; i < history_.size(); i++) {
+    AddTrickCard(history_.at(i).action);
+  }
+  data_.current_player = player;
+  auto [trick_winner, winning_action] =
+      ResolveTrickWinnerAndWinningAction<kNumPlayers>();
+  CardSet& trick_winner_collected_cards =
+      data_.players_collected_cards.at(trick_winner);
+  trick_winner_collected_cards &= ~TrickCardSet();
+
+  if (SelectedContract().name == ContractName::kKlop && num_tricks <= 6) {
+    // talon cards are gifted from left to right, one per trick
+    int gift_position = num_tricks - 1;
+    trick_winner_collected_cards &=
+        ~CardActionToCardSet(data_.talon.at(gift_position));
+    data_.talon_positions |= 1 << gift_position;
+  } else if (winning_action == data_.called_king &&
+             data_.called_king_in_talon) {
+    // the talon remainder consists of all but the selected talon set, the
+    // selecting action precedes the discarding actions in history
+    int num_talon_exchanges = SelectedContract().num_talon_exchanges;
+    open_spiel::Action talon_set_action =
+        history_.at(history_.size() - num_played - num_talon_exchanges - 1)
+            .action;
+    data_.talon_positions =
+        kAllTalonPositions & ~(((1 << num_talon_exchanges) - 1)
+                               << (talon_set_action * num_talon_exchanges));
+    CardSet talon_cards = TalonCardSet();
+    trick_winner_collected_cards &= ~talon_cards;
+    if (CardActionInCardSet(kMondAction, talon_cards))
+      data_.captured_mond_player = data_.declarer;
+  } else if ((SelectedContract().NeedsTalonExchange() ||
+              SelectedContract().name == ContractName::kSoloWithout) &&
+             (winning_action == kSkisAction ||
+              winning_action == kPagatAction) &&
+             CardActionInCardSet(kMondAction, TrickCardSet())) {
+    data_.captured_mond_player = open_spiel::kInvalidPlayer;
+  }
+
+  // the previous trick precedes the resolved one in history
+  data_.last_trick_cards = {};
+  if (num_tricks > 1) {
+    int previous_trick_begin = history_.size() - 2 * kNumPlayers;
+    for (int i = 0; i < kNumPlayers; i++) {
+      data_.last_trick_cards.at(i) =
+          history_.at(previous_trick_begin + i).action;
+    }
+  }
+}
+
+template <int kNumPlayers>
 void TarokState::NextPlayer() {
-  current_player_ += 1;
-  if (current_player_ == num_players_) current_player_ = 0;
+  data_.current_player += 1;
+  if (data_.current_player == kNumPlayers) data_.current_player = 0;
 }
 
-bool TarokState::ActionInActions(
-    open_spiel::Action action_id,
-    const std::vector<open_spiel::Action>& actions) {
-  return std::find(actions.begin(), actions.end(), action_id) != actions.end();
+const Contract& TarokState::SelectedContract() const {
+  return tarok_parent_game_->contracts_.at(data_.selected_contract);
 }
 
-void TarokState::MoveActionFromTo(open_spiel::Action action_id,
-                                  std::vector<open_spiel::Action>* from,
-                                  std::vector<open_spiel::Action>* to) {
-  from->erase(std::remove(from->begin(), from->end(), action_id), from->end());
-  to->push_back(action_id);
+int TarokState::TalonSize() const {
+  return __builtin_popcount(data_.talon_positions);
 }
 
-const Card& TarokState::ActionToCard(open_spiel::Action action_id) const {
-  return tarok_parent_game_->card_deck_.at(action_id);
+CardSet TarokState::DealtTalonCardSet() const {
+  if (data_.current_game_phase == GamePhase::kCardDealing) return kEmptyCardSet;
+  CardSet cards = kEmptyCardSet;
+  for (auto const& action : data_.talon) cards |= CardActionToCardSet(action);
+  return cards;
 }
 
-void TarokState::AppendToAllInformationStates(const std::string& appendix) {
-  for (int i = 0; i < num_players_; i++) {
-    absl::StrAppend(&players_info_states_.at(i), appendix);
+CardSet TarokState::TalonCardSet() const {
+  CardSet cards = kEmptyCardSet;
+  for (int i = 0; i < 6; i++) {
+    if (data_.talon_positions & (1 << i))
+      cards |= CardActionToCardSet(data_.talon.at(i));
   }
+  return cards;
 }
 
-void TarokState::AppendToInformationState(open_spiel::Player player,
-                                          const std::string& appendix) {
-  absl::StrAppend(&players_info_states_.at(player), appendix);
+CardSet TarokState::TrickCardSet() const {
+  return data_.trick_cards.ToCardSet();
+}
+
+CardSet TarokState::LastTrickCardSet() const {
+  CardSet cards = kEmptyCardSet;
+  for (int i = 0; i < num_players_; i++) {
+    cards |= CardActionToCardSet(data_.last_trick_cards.at(i));
+  }
+  return cards;
 }
 
 std::ostream& operator<<(std::ostream& os, const GamePhase& game_phase) {
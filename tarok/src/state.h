@@ -2,10 +2,13 @@
 
 #pragma once
 
+#include <array>
 #include <iostream>
 #include <memory>
+#include <random>
 #include <string>
 #include <tuple>
+#include <type_traits>
 #include <vector>
 
 #include "open_spiel/spiel.h"
@@ -14,7 +17,7 @@
 
 namespace tarok {
 
-enum class GamePhase {
+enum class GamePhase : int8_t {
   kCardDealing,
   kBidding,
   kKingCalling,
@@ -25,24 +28,151 @@ enum class GamePhase {
 
 class TarokGame;
 
+// a set of actions encoded as a bitmask where the i-th bit corresponds to the
+// action i, this works in all game phases since all actions are lower than 54
+using ActionBitmask = uint64_t;
+
+// picks one of the actions of a non-empty bitmask uniformly at random
+inline open_spiel::Action RandomAction(ActionBitmask actions,
+                                       std::mt19937* rng) {
+  for (int i = (*rng)() % __builtin_popcountll(actions); i > 0; i--)
+    actions &= actions - 1;
+  return __builtin_ctzll(actions);
+}
+
 using TrickWinnerAndAction = std::tuple<open_spiel::Player, open_spiel::Action>;
-using CollectedCardsPerTeam = std::tuple<std::vector<open_spiel::Action>,
-                                         std::vector<open_spiel::Action>>;
+using CollectedCardsPerTeam = std::tuple<CardSet, CardSet>;
+
+// all mutable state of a single game round packed into a trivially copyable
+// struct so that cloning amounts to a memcpy, players and actions are stored
+// as int8_t and per player arrays are sized for the maximum number of players
+struct TarokStateData {
+  std::array<CardSet, 4> players_cards{};
+  std::array<CardSet, 4> players_collected_cards{};
+  // cards played in tricks, kept up to date for observation tensors
+  std::array<CardSet, 4> players_played_cards{};
+  // seed of the RNG used for dealing the cards once the card dealing action is
+  // applied
+  int deal_seed = 0;
+  GamePhase current_game_phase = GamePhase::kCardDealing;
+  int8_t current_player = open_spiel::kInvalidPlayer;
+  // talon and trick cards are kept in the order in which they were dealt or
+  // played since the order carries meaning (talon sets are formed from left to
+  // right and trick_cards indices determine the players), all other card
+  // collections are represented as card sets
+  std::array<int8_t, 6> talon{};
+  // the i-th bit is set while the i-th dealt talon card is still part of the
+  // talon, cards are never removed from talon itself so that they can be put
+  // back when undoing actions
+  uint8_t talon_positions = 0;
+  CardActions<4> trick_cards;
+  // cards of the last resolved trick, used for the ultimo bonuses
+  std::array<int8_t, 4> last_trick_cards{};
+  std::array<int8_t, 4> players_bids{kInvalidBidAction, kInvalidBidAction,
+                                     kInvalidBidAction, kInvalidBidAction};
+  int8_t declarer = open_spiel::kInvalidPlayer;
+  // index of the contract within TarokGame::contracts_
+  int8_t selected_contract = -1;
+  int8_t called_king = open_spiel::kInvalidAction;
+  bool called_king_in_talon = false;
+  int8_t declarer_partner = open_spiel::kInvalidPlayer;
+  int8_t captured_mond_player = open_spiel::kInvalidPlayer;
+};
+
+static_assert(std::is_trivially_copyable_v<TarokStateData>);
+static_assert(sizeof(TarokStateData) <= 128);
+
+// what all players know about the location of cards, kept up to date as
+// actions are applied and undone (see TarokState::PubliclyExcludedCards()) and
+// apart from TarokStateData since the log needed for undoing doesn't fit into
+// its packed size
+struct PublicInferences {
+  std::array<CardSet, 4> players_excluded_cards{};
+  // the i-th bitmask holds the players that might hold the card with action i
+  std::array<uint8_t, 54> possible_card_holders{};
+  // cards that players can't hold according to the rules of playing tricks as
+  // inferred from the cards they played (e.g. a player who didn't follow suit
+  // is void in that suit), a subset of players_excluded_cards
+  std::array<CardSet, 4> players_trick_excluded_cards{};
+  // cards that the i-th card played in tricks added to its player's trick
+  // excluded cards, these are removed again when the card is undone
+  std::array<CardSet, 48> added_trick_excluded_cards{};
+  // both are empty until the declarer selects the talon set, discarded cards
+  // include the ones that are hidden from other players
+  CardSet selected_talon_set = kEmptyCardSet;
+  CardSet discarded_cards = kEmptyCardSet;
+};
+
+static_assert(std::is_trivially_copyable_v<PublicInferences>);
+
+// each player's info state key is the XOR of keys of the observed actions
+// (where the dealt cards are the first one) mixed with their position among
+// the actions the player observed, this makes undoing an action the same as
+// applying it
+struct InformationStateKeys {
+  std::array<uint64_t, 4> keys{};
+  std::array<uint8_t, 4> num_observed_actions{};
+};
 
 class TarokState : public open_spiel::State {
  public:
-  explicit TarokState(std::shared_ptr<const open_spiel::Game> game);
+  // cards are dealt from the given seed once the card dealing action is
+  // applied, see TarokGame::NewInitialTarokState()
+  TarokState(std::shared_ptr<const open_spiel::Game> game, int deal_seed);
+  // resets the state in place to the card dealing of the deal with the given
+  // seed, i.e. to the same state as a newly created one, without allocations
+  // once the history has grown (see TarokVectorEnv)
+  void ResetForDeal(int deal_seed);
 
   open_spiel::Player CurrentPlayer() const override;
   bool IsTerminal() const override;
   GamePhase CurrentGamePhase() const;
+  // seed the cards are dealt from, deals are the same for equal seeds
+  int DealSeed() const;
   std::vector<open_spiel::Action> PlayerCards(open_spiel::Player player) const;
   ContractName SelectedContractName() const;
   std::vector<open_spiel::Action> Talon() const;
   std::vector<std::vector<open_spiel::Action>> TalonSets() const;
   std::vector<open_spiel::Action> TrickCards() const;
+  // allocation free reads of the position for search algorithms and samplers
+  // that keep their own state (see DoubleDummySolver and
+  // DeterminizationSampler), players are kInvalidPlayer and the called king is
+  // kInvalidAction until they're known in the game
+  CardSet PlayerCardSet(open_spiel::Player player) const;
+  CardSet CollectedCardSet(open_spiel::Player player) const;
+  CardSet PlayedCardSet(open_spiel::Player player) const;
+  open_spiel::Player Declarer() const;
+  // kInvalidPlayer if no king was called or the called king is in talon
+  open_spiel::Player DeclarerPartner() const;
+  open_spiel::Action CalledKing() const;
+  bool CalledKingInTalon() const;
+  open_spiel::Player CapturedMondPlayer() const;
+  // only valid once the contract is selected
+  const Contract& SelectedContract() const;
+  // all talon cards once they're dealt, including the ones that left the talon
+  CardSet DealtTalonCardSet() const;
+  // cards that are still part of the talon
+  CardSet TalonCardSet() const;
+  // see PublicInferences::selected_talon_set and discarded_cards
+  std::tuple<CardSet, CardSet> SelectedTalonSetAndDiscardedCards() const;
+
+  // cards that all players know the given player doesn't hold, i.e. played
+  // cards, talon cards shown to all players (but the selected talon set for
+  // the declarer), shown discarded taroks and cards the player can't hold
+  // according to the rules of playing tricks (e.g. all cards of a suit the
+  // player didn't follow), the inferences are kept up to date as actions are
+  // applied and undone so these methods are plain reads
+  CardSet PubliclyExcludedCards(open_spiel::Player player) const;
+  // bitmask of players that might hold the card as far as all players know
+  uint8_t PossibleCardHolders(open_spiel::Action action_id) const;
+  bool IsPubliclyVoidInSuit(open_spiel::Player player, CardSuit suit) const;
 
   std::vector<open_spiel::Action> LegalActions() const override;
+  // returns the same actions as LegalActions() but without any heap
+  // allocations which makes it suitable for tight search and rollout loops,
+  // legal actions can be iterated over in ascending order by repeatedly
+  // taking LowestCardAction() and clearing the lowest set bit
+  ActionBitmask LegalActionsBitmask() const;
   std::string ActionToString(open_spiel::Player player,
                              open_spiel::Action action_id) const override;
   std::string CardActionToString(open_spiel::Action action_id) const;
@@ -69,87 +199,205 @@ class TarokState : public open_spiel::State {
   // each_players_private_cards;bidding_actions;king_calling_action;
   // talon_cards;choosing_talon_set_action;discarding_cards_actions;
   // single_trick_played_actions;...;single_trick_played_actions
+  //
+  // note that info states are not kept up to date while playing but are
+  // rendered from the dealt cards and history on every call without replaying
+  // any actions, i.e. applying and undoing actions never builds strings
   std::string InformationStateString(open_spiel::Player player) const override;
+  // 64-bit fingerprint of InformationStateString(), i.e. equal info state
+  // strings always have equal keys while different ones collide with a
+  // probability of about 2^-64, keys are kept up to date as actions are
+  // applied and undone so that this never renders the string, they're
+  // deterministic and thus stable across runs and platforms
+  uint64_t InformationStateKey(open_spiel::Player player) const;
+
+  // info state tensors are of a fixed size (see
+  // TarokGame::InformationStateTensorShape()) and consist of the following
+  // parts, where cards are encoded as 54 values indexed by card actions:
+  //   - the observing player (num_players)
+  //   - observing player's dealt cards (54)
+  //   - each player's last bid (num_players x 13)
+  //   - the called king (4)
+  //   - talon cards shown to all players (54)
+  //   - cards in the selected talon set (54)
+  //   - discarded cards visible to the observing player (54)
+  //   - for each trick, the player who opened it (num_players) and cards
+  //     played by each player (num_players x 54)
+  void InformationStateTensor(open_spiel::Player player,
+                              absl::Span<float> values) const override;
+
+  // observation tensors only encode the current state of the game instead of
+  // its whole history, players are indexed by their seat relative to the
+  // observing player (i.e. 0 is the observing player, 1 is the next one,
+  // etc.) and the tensor consists of the following parts:
+  //   - observing player's current cards (54)
+  //   - each player's last bid (num_players x 13)
+  //   - the selected contract (12)
+  //   - the declarer (num_players)
+  //   - whether the declarer's partner is known to the observing player (1)
+  //     and the partner if so (num_players)
+  //   - cards in the current trick played by each player (num_players x 54)
+  //   - cards played so far by each player (num_players x 54)
+  //   - points collected so far by each player divided by 70 (num_players)
+  void ObservationTensor(open_spiel::Player player,
+                         absl::Span<float> values) const override;
 
   std::string ToString() const override;
+  // states are equal if they're in the same position of the same game, no
+  // matter which actions led to it (i.e. history and the deal seed are
+  // ignored as well as trick inferences since they follow from history)
+  bool operator==(const TarokState& other) const;
+  bool operator!=(const TarokState& other) const;
+  // zobrist hash of the position that is kept up to date as actions are
+  // applied and undone, it covers all players' current and collected cards,
+  // trick cards and the scalar state (e.g. current player, game phase,
+  // contract and bids), equal states always have equal hashes
+  uint64_t Hash() const;
+  // copies the packed TarokStateData and PublicInferences, note that
+  // open_spiel::State still copies its game pointer and history
   std::unique_ptr<State> Clone() const override;
+  // undoes the last action in history in any game phase without allocating,
+  // information that is lost when applying actions (e.g. the previous bid of
+  // a player or the talon set selection) is recovered from history
+  void UndoAction(open_spiel::Player player,
+                  open_spiel::Action action_id) override;
+
+  // same as ApplyAction() but skips checking whether the action is legal in
+  // release builds (i.e. when NDEBUG is defined), this is meant for trusted
+  // agents such as search and rollouts that only ever choose among the
+  // actions returned by LegalActions() or LegalActionsBitmask()
+  void ApplyTrustedAction(open_spiel::Action action_id);
+  // replaces the cards that are hidden from other players, i.e. players'
+  // cards, the remaining talon cards (in order) unless talon is empty and the
+  // declarer's discarded non-taroks together with their discarding actions in
+  // history, the hash, info state keys and the declarer's partner are updated
+  // to match so that the state behaves as if the replaced cards were dealt,
+  // the caller has to keep the cards that any player observed in place (see
+  // DeterminizationSampler)
+  void ReplaceHiddenCards(const std::array<CardSet, 4>& players_cards,
+                          const CardActions<6>& talon,
+                          CardSet discarded_cards);
 
  protected:
   void DoApplyAction(open_spiel::Action action_id) override;
 
  private:
-  std::vector<open_spiel::Action> LegalActionsInBidding() const;
-  std::vector<open_spiel::Action> LegalActionsInTalonExchange() const;
-  std::vector<open_spiel::Action> LegalActionsInTricksPlaying() const;
-  std::vector<open_spiel::Action> LegalActionsInTricksPlayingFollowing() const;
-
-  // checks whether the current player can follow the opening card suit or
-  // can't but still has at least one tarok, if the first value is true, the
-  // second might be set incorrectly as it is irrelevant
-  std::tuple<bool, bool> CanFollowSuitOrCantButHasTarok() const;
-
-  std::vector<open_spiel::Action> TakeSuitFromPlayerCardsInNegativeContracts(
-      CardSuit suit) const;
-  std::optional<open_spiel::Action> ActionToBeatInNegativeContracts(
-      CardSuit suit) const;
-  std::vector<open_spiel::Action> RemovePagatIfNeeded(
-      const std::vector<open_spiel::Action>& actions) const;
-  std::vector<open_spiel::Action> TakeSuitFromPlayerCardsInPositiveContracts(
-      CardSuit suit) const;
+  void CheckLegalAction(open_spiel::Action action_id) const;
+  // legal actions, applying and undoing actions are instantiated for three
+  // and four players so that trick sizes, hand sizes, per player loops and
+  // the wrapping of player indices are compile time constants in the paths
+  // taken by search and rollouts, the non-template versions only dispatch on
+  // the number of players
+  template <int kNumPlayers>
+  ActionBitmask LegalActionsBitmask() const;
+  void DoApplyTrustedAction(open_spiel::Action action_id);
+  template <int kNumPlayers>
+  void DoApplyTrustedAction(open_spiel::Action action_id);
+  template <int kNumPlayers>
+  void DoUndoAction(open_spiel::Player player, open_spiel::Action action_id);
+  uint64_t ComputeHash() const;
+  // updates the hash with the changes made since the previous data
+  template <int kNumPlayers>
+  void UpdateHash(const TarokStateData& previous_data);
+
+  template <int kNumPlayers>
+  ActionBitmask LegalActionsInBidding() const;
+  ActionBitmask LegalActionsInTalonExchange() const;
+  ActionBitmask LegalActionsInTricksPlaying() const;
 
   void DoApplyActionInCardDealing();
+  // toggles each player's observation of the action applied in the current
+  // state in the info state keys, i.e. this is called before applying and
+  // after undoing the action
+  template <int kNumPlayers>
+  void UpdateInformationStateKeys(open_spiel::Action action_id, bool undo);
+  // updates the info state keys after the dealt cards or a hidden discarded
+  // card were replaced (see ReplaceHiddenCards())
+  void ReplaceDealtCardsInInformationStateKey(open_spiel::Player player,
+                                              CardSet previous_dealt_cards);
+  void ReplaceDiscardedCardInInformationStateKey(
+      int history_index, open_spiel::Action previous_action);
+  void StartBiddingPhase();
   bool AnyPlayerWithoutTaroks() const;
+  template <int kNumPlayers>
   void DoApplyActionInBidding(open_spiel::Action action_id);
+  template <int kNumPlayers>
   bool AllButCurrentPlayerPassedBidding() const;
+  template <int kNumPlayers>
   void FinishBiddingPhase(open_spiel::Action action_id);
   void DoApplyActionInKingCalling(open_spiel::Action action_id);
+  template <int kNumPlayers>
   void DoApplyActionInTalonExchange(open_spiel::Action action_id);
   void StartTricksPlayingPhase();
+  template <int kNumPlayers>
   void DoApplyActionInTricksPlaying(open_spiel::Action action_id);
+  // cards the current player can't hold given that they play the card
+  CardSet InferExcludedCards(open_spiel::Action action_id) const;
+  // publicly excluded cards computed from the state instead of being kept up
+  // to date, used after actions that change them apart from played cards
+  CardSet ComputePubliclyExcludedCards(open_spiel::Player player) const;
+  void UpdatePubliclyExcludedCards();
+  // adds the cards to the player's publicly excluded cards
+  void ExcludeCardsPublicly(open_spiel::Player player, CardSet cards);
+  // adds the card to the trick cards and updates the winning card
+  void AddTrickCard(open_spiel::Action action_id);
+  template <int kNumPlayers>
   void ResolveTrick();
+  template <int kNumPlayers>
   TrickWinnerAndAction ResolveTrickWinnerAndWinningAction() const;
+  // computes the index of the winning card within the given trick cards
+  int WinningTrickCardsIndex(const CardActions<4>& trick_cards) const;
+  bool TaroksAreTrumps() const;
 
-  // computes which player belongs to the trick_cards_ index as the player
-  // who opens the trick always belongs to index 0 within trick_cards_
+  // computes which player belongs to the trick cards index as the player
+  // who opens the trick always belongs to index 0 within trick cards
+  template <int kNumPlayers>
   open_spiel::Player TrickCardsIndexToPlayer(int index) const;
+  int NumCardsPlayedInTricks() const;
+  // cards the player was dealt, recovered from the current state and history
+  CardSet DealtPlayerCards(open_spiel::Player player) const;
 
-  std::vector<int> ScoresInKlop() const;
-  std::vector<int> ScoresInNormalContracts() const;
+  // scores of a finished game without captured mond penalties, computed
+  // from the collected card sets with integer arithmetic only and without
+  // any heap allocations, values past the number of players are zero
+  std::array<int, 4> Scores() const;
+  std::array<int, 4> ScoresInKlop() const;
+  std::array<int, 4> ScoresInNormalContracts() const;
   CollectedCardsPerTeam SplitCollectedCardsPerTeams() const;
-  int NonValatBonuses(
-      const std::vector<open_spiel::Action>& collected_cards,
-      const std::vector<open_spiel::Action>& opposite_collected_cards) const;
+  int NonValatBonuses(CardSet collected_cards,
+                      CardSet opposite_collected_cards) const;
   std::tuple<bool, bool> CollectedKingsAndOrTrula(
-      const std::vector<open_spiel::Action>& collected_cards) const;
-  std::vector<int> ScoresInHigherContracts() const;
+      CardSet collected_cards) const;
+  std::array<int, 4> ScoresInHigherContracts() const;
 
+  void UndoActionInBidding(open_spiel::Player player);
+  void UndoActionInKingCalling(open_spiel::Player player);
+  template <int kNumPlayers>
+  void UndoActionInTalonExchange(open_spiel::Player player,
+                                 open_spiel::Action action_id);
+  template <int kNumPlayers>
+  void UndoActionInTricksPlaying(open_spiel::Player player,
+                                 open_spiel::Action action_id);
+  template <int kNumPlayers>
+  void UndoResolveTrick(open_spiel::Player player);
+
+  template <int kNumPlayers>
   void NextPlayer();
-  static bool ActionInActions(open_spiel::Action action_id,
-                              const std::vector<open_spiel::Action>& actions);
-  static void MoveActionFromTo(open_spiel::Action action_id,
-                               std::vector<open_spiel::Action>* from,
-                               std::vector<open_spiel::Action>* to);
-  const Card& ActionToCard(open_spiel::Action action_id) const;
-  void AppendToAllInformationStates(const std::string& appendix);
-  void AppendToInformationState(open_spiel::Player player,
-                                const std::string& appendix);
-
-  std::shared_ptr<const TarokGame> tarok_parent_game_;
-  GamePhase current_game_phase_ = GamePhase::kCardDealing;
-  open_spiel::Player current_player_ = open_spiel::kInvalidPlayer;
-  std::vector<open_spiel::Action> talon_;
-  std::vector<std::vector<open_spiel::Action>> players_cards_;
-  std::vector<open_spiel::Action> players_bids_;
-  open_spiel::Player declarer_ = open_spiel::kInvalidPlayer;
-  // contract pointed to is managed by the game instance
-  const Contract* selected_contract_;
-  open_spiel::Action called_king_ = open_spiel::kInvalidAction;
-  bool called_king_in_talon_ = false;
-  open_spiel::Player declarer_partner_ = open_spiel::kInvalidPlayer;
-  std::vector<std::vector<open_spiel::Action>> players_collected_cards_;
-  std::vector<open_spiel::Action> trick_cards_;
-  open_spiel::Player captured_mond_player_ = open_spiel::kInvalidPlayer;
-  std::vector<std::string> players_info_states_;
+  int TalonSize() const;
+  CardSet TrickCardSet() const;
+  CardSet LastTrickCardSet() const;
+
+  // the game is kept alive by open_spiel::State, a raw pointer avoids reference
+  // counting when cloning
+  const TarokGame* tarok_parent_game_;
+  TarokStateData data_;
+  PublicInferences public_inferences_;
+  // the i-th index is the index of the winning card among the first i + 1
+  // trick cards, set as cards are played so that resolving a trick doesn't
+  // compare cards, entries past the current trick cards are stale
+  std::array<int8_t, 4> winning_trick_cards_indices_{};
+  uint64_t hash_;
+  InformationStateKeys information_state_keys_;
 };
 
 std::ostream& operator<<(std::ostream& os, const GamePhase& game_phase);
@@ -0,0 +1,112 @@
+/* Copyright 2020 Semantic Weights. All rights reserved. */
+
+#include "src/thread_pool.h"
+
+#include <utility>
+
+#include "open_spiel/spiel_utils.h"
+
+namespace tarok {
+
+// the pool and queue index of the current thread if it belongs to a pool
+static thread_local const ThreadPool* current_pool = nullptr;
+static thread_local int current_thread_index = -1;
+
+ThreadPool::ThreadPool(int num_threads) {
+  SPIEL_CHECK_GE(num_threads, 1);
+  queues_.reserve(num_threads);
+  for (int i = 0; i < num_threads; i++)
+    queues_.push_back(std::make_unique<TaskQueue>());
+  threads_.reserve(num_threads);
+  for (int i = 0; i < num_threads; i++)
+    threads_.emplace_back(&ThreadPool::RunThread, this, i);
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  task_submitted_.notify_all();
+  for (auto& thread : threads_) thread.join();
+}
+
+void ThreadPool::Submit(std::function<void()> task) {
+  int queue_index;
+  if (current_pool == this) {
+    queue_index = current_thread_index;
+  } else {
+    std::lock_guard<std::mutex> lock(mutex_);
+    queue_index = next_queue_;
+    next_queue_ = (next_queue_ + 1) % queues_.size();
+  }
+  {
+    TaskQueue& queue = *queues_.at(queue_index);
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    queue.tasks.push_back(std::move(task));
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    num_queued_tasks_++;
+    num_pending_tasks_++;
+  }
+  task_submitted_.notify_one();
+}
+
+void ThreadPool::Wait() {
+  SPIEL_CHECK_FALSE(current_pool == this);
+  std::unique_lock<std::mutex> lock(mutex_);
+  all_tasks_finished_.wait(lock, [this]() { return num_pending_tasks_ == 0; });
+}
+
+int ThreadPool::NumThreads() const { return threads_.size(); }
+
+void ThreadPool::RunThread(int thread_index) {
+  current_pool = this;
+  current_thread_index = thread_index;
+  std::function<void()> task;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      task_submitted_.wait(
+          lock, [this]() { return stopping_ || num_queued_tasks_ > 0; });
+      if (num_queued_tasks_ == 0) return;
+      // claims one of the queued tasks, tasks are counted only after they are
+      // pushed to a queue and every thread takes only as many tasks as it has
+      // claimed so there's always a task left to be taken
+      num_queued_tasks_--;
+    }
+    bool taken = TakeTask(thread_index, &task);
+    SPIEL_CHECK_TRUE(taken);
+    task();
+    task = nullptr;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (--num_pending_tasks_ == 0) all_tasks_finished_.notify_all();
+    }
+  }
+}
+
+bool ThreadPool::TakeTask(int thread_index, std::function<void()>* task) {
+  {
+    TaskQueue& queue = *queues_.at(thread_index);
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (!queue.tasks.empty()) {
+      *task = std::move(queue.tasks.back());
+      queue.tasks.pop_back();
+      return true;
+    }
+  }
+  for (size_t i = 1; i < queues_.size(); i++) {
+    TaskQueue& queue = *queues_.at((thread_index + i) % queues_.size());
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (!queue.tasks.empty()) {
+      *task = std::move(queue.tasks.front());
+      queue.tasks.pop_front();
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace tarok
@@ -0,0 +1,60 @@
+/* Copyright 2020 Semantic Weights. All rights reserved. */
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace tarok {
+
+// a fixed size pool of threads that run submitted tasks, each thread has its
+// own queue of tasks from which it takes the most recently submitted task
+// first and, once the queue is empty, steals the least recently submitted
+// task from the queues of other threads, this keeps all threads busy when
+// running times of tasks vary a lot (e.g. double dummy solves of different
+// contracts), tasks submitted from outside of the pool are distributed among
+// the queues in round robin fashion while tasks submitted from within a
+// running task are put to the queue of the running thread
+class ThreadPool {
+ public:
+  explicit ThreadPool(int num_threads);
+  // waits for all submitted tasks to finish
+  ~ThreadPool();
+
+  void Submit(std::function<void()> task);
+  // blocks until all submitted tasks (including the ones submitted while
+  // waiting) are finished, must not be called from within a task
+  void Wait();
+  int NumThreads() const;
+
+ private:
+  struct TaskQueue {
+    std::mutex mutex;
+    std::deque<std::function<void()>> tasks;
+  };
+
+  void RunThread(int thread_index);
+  // takes a task from the given thread's queue or steals one from the others,
+  // returns false if all queues are empty
+  bool TakeTask(int thread_index, std::function<void()>* task);
+
+  std::vector<std::unique_ptr<TaskQueue>> queues_;
+  std::vector<std::thread> threads_;
+  // guards the counters below
+  std::mutex mutex_;
+  std::condition_variable task_submitted_;
+  std::condition_variable all_tasks_finished_;
+  // submitted tasks that weren't taken by any thread yet
+  int num_queued_tasks_ = 0;
+  // submitted tasks that didn't finish yet
+  int num_pending_tasks_ = 0;
+  int next_queue_ = 0;
+  bool stopping_ = false;
+};
+
+}  // namespace tarok
@@ -0,0 +1,159 @@
+/* Copyright 2020 Semantic Weights. All rights reserved. */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+
+#include "absl/types/optional.h"
+#include "open_spiel/spiel.h"
+#include "src/cards.h"
+
+namespace tarok {
+
+// rules of playing tricks on card sets, shared by TarokState and search
+// algorithms that keep their own lean state (see DoubleDummySolver), they're
+// defined in the header so that they're inlined into tight search loops
+
+static constexpr CardSet kMondAndSkisCardSet =
+    CardActionToCardSet(kMondAction) | CardActionToCardSet(kSkisAction);
+
+// the i-th card set holds the cards that beat the card with action i when it
+// is winning the trick, i.e. higher cards of the same suit and, as long as
+// taroks are trumps, all higher taroks, note that the emperor trick is not
+// covered by these
+struct BeatingCardSets {
+  std::array<CardSet, 54> with_trumps;
+  std::array<CardSet, 54> without_trumps;
+};
+
+constexpr BeatingCardSets InitializeBeatingCardSets() {
+  BeatingCardSets sets{};
+  for (int winning = 0; winning < 54; winning++) {
+    for (int action = 0; action < 54; action++) {
+      if (CardActionRank(action) <= CardActionRank(winning)) continue;
+      if (CardActionSuit(action) == CardActionSuit(winning)) {
+        sets.with_trumps[winning] |= CardActionToCardSet(action);
+        sets.without_trumps[winning] |= CardActionToCardSet(action);
+      } else if (CardActionSuit(action) == CardSuit::kTaroks) {
+        sets.with_trumps[winning] |= CardActionToCardSet(action);
+      }
+    }
+  }
+  return sets;
+}
+
+static constexpr BeatingCardSets kBeatingCardSets = InitializeBeatingCardSets();
+
+// computes the index of the winning card after the card at the given index
+// was added to the trick cards, given the index of the winning card among
+// the cards before it, this only looks up the beating cards of the winning
+// card unless the added card completes the emperor trick, taroks aren't trumps
+// in Contract::kColourValatWithout only
+inline int NextWinningTrickCardsIndex(const CardActions<4>& trick_cards,
+                                      int index, int winning_action_i,
+                                      bool taroks_are_trumps) {
+  open_spiel::Action action = trick_cards.at(index);
+  if (CardActionInCardSet(action, kTrulaCardSet)) {
+    CardSet trick_card_set = kEmptyCardSet;
+    for (int i = 0; i <= index; i++)
+      trick_card_set |= CardActionToCardSet(trick_cards.at(i));
+    if ((trick_card_set & kTrulaCardSet) == kTrulaCardSet &&
+        (taroks_are_trumps ||
+         CardActionSuit(trick_cards.front()) == CardSuit::kTaroks)) {
+      // the emperor trick, i.e. pagat wins over mond and skis in all cases
+      // but not in Contract::kColourValatWithout when a non-trump is led
+      return std::find(trick_cards.begin(), trick_cards.end(), kPagatAction) -
+             trick_cards.begin();
+    }
+  }
+  const auto& beating_card_sets = taroks_are_trumps
+                                      ? kBeatingCardSets.with_trumps
+                                      : kBeatingCardSets.without_trumps;
+  if (CardActionInCardSet(action,
+                          beating_card_sets[trick_cards.at(winning_action_i)]))
+    return index;
+  return winning_action_i;
+}
+
+// mustn't play pagat unless it's the only card, note that cards can be all
+// player's cards or a subset already filtered by the caller
+inline CardSet RemovePagatIfNeeded(CardSet cards) {
+  if (CardSetSize(cards) > 1)
+    return cards & ~CardActionToCardSet(kPagatAction);
+  return cards;
+}
+
+// the highest card of the suit that has to be beaten in negative contracts,
+// if any, where the suit is the one the player has to play
+inline absl::optional<open_spiel::Action> ActionToBeatInNegativeContracts(
+    const CardActions<4>& trick_cards, CardSuit suit) {
+  // there are two cases where no card has to be beaten; the player is following
+  // a colour suit and there is already at least one tarok in trick cards or
+  // the player is forced to play a tarok and there are no taroks in trick cards
+  bool tarok_in_trick_cards =
+      (trick_cards.ToCardSet() & SuitToCardSet(CardSuit::kTaroks)) !=
+      kEmptyCardSet;
+  if ((suit != CardSuit::kTaroks && tarok_in_trick_cards) ||
+      (suit == CardSuit::kTaroks && !tarok_in_trick_cards)) {
+    return {};
+  }
+  // the specified suit should be present in trick cards from here on because
+  // it is either a suit of the opening card or CardSuit::kTaroks with existing
+  // taroks in trick cards
+  open_spiel::Action action_to_beat = trick_cards.front();
+  for (int i = 1; i < trick_cards.size(); i++) {
+    open_spiel::Action action = trick_cards.at(i);
+    if (CardActionSuit(action) == suit &&
+        CardActionRank(action) > CardActionRank(action_to_beat)) {
+      action_to_beat = action;
+    }
+  }
+  return action_to_beat;
+}
+
+// cards of the player that can be played into the trick, i.e. all cards when
+// opening it (but pagat in negative contracts), otherwise cards of the opening
+// suit, taroks if the player can't follow suit and any card if the player has
+// neither, in negative contracts the trick has to be beaten if possible
+inline CardSet LegalTrickCards(CardSet player_cards,
+                               const CardActions<4>& trick_cards,
+                               bool is_negative) {
+  if (trick_cards.empty()) {
+    if (is_negative) return RemovePagatIfNeeded(player_cards);
+    return player_cards;
+  }
+
+  CardSuit take_suit = CardActionSuit(trick_cards.front());
+  CardSet cards = player_cards & SuitToCardSet(take_suit);
+  if (cards == kEmptyCardSet) {
+    take_suit = CardSuit::kTaroks;
+    cards = player_cards & SuitToCardSet(CardSuit::kTaroks);
+    // can't follow suit and doesn't have taroks so any card can be played
+    if (cards == kEmptyCardSet) return player_cards;
+  }
+  if (!is_negative) return cards;
+
+  bool player_has_pagat = CardActionInCardSet(kPagatAction, player_cards);
+  if (player_has_pagat &&
+      (trick_cards.ToCardSet() & kMondAndSkisCardSet) == kMondAndSkisCardSet) {
+    // the emperor trick, i.e. pagat has to be played as it is the only card
+    // that will win the trick
+    return CardActionToCardSet(kPagatAction);
+  }
+  absl::optional<open_spiel::Action> action_to_beat =
+      ActionToBeatInNegativeContracts(trick_cards, take_suit);
+  if (action_to_beat) {
+    // cards within a suit are ordered by rank so all higher cards of the suit
+    // are those with higher card actions, a higher card only has to be played
+    // when the player actually has a higher card otherwise any card of the
+    // suit can be played
+    CardSet higher_cards =
+        cards & ~(CardActionToCardSet(*action_to_beat + 1) - 1);
+    if (higher_cards != kEmptyCardSet) cards = higher_cards;
+  }
+  if (player_has_pagat) return RemovePagatIfNeeded(cards);
+  return cards;
+}
+
+}  // namespace tarok
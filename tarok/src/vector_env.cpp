@@ -0,0 +1,101 @@
+/* Copyright 2020 Semantic Weights. All rights reserved. */
+
+#include "src/vector_env.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace tarok {
+
+TarokVectorEnv::TarokVectorEnv(std::shared_ptr<const TarokGame> game,
+                               int num_envs)
+    : game_(std::move(game)),
+      num_envs_(num_envs),
+      num_players_(game_->NumPlayers()),
+      num_actions_(game_->NumDistinctActions()),
+      tensor_size_(game_->InformationStateTensorSize()),
+      current_players_(num_envs),
+      legal_actions_masks_(num_envs * num_actions_),
+      rewards_(num_envs * num_players_),
+      dones_(num_envs),
+      info_state_tensors_(num_envs * tensor_size_) {
+  SPIEL_CHECK_GT(num_envs_, 0);
+  // reserving up front keeps the states from being moved around
+  states_.reserve(num_envs_);
+  for (int i = 0; i < num_envs_; i++) states_.emplace_back(game_, 0);
+  Reset();
+}
+
+void TarokVectorEnv::Reset() {
+  std::fill(rewards_.begin(), rewards_.end(), 0);
+  std::fill(dones_.begin(), dones_.end(), 0);
+  for (int i = 0; i < num_envs_; i++) {
+    Deal(i);
+    WriteObservations(i);
+  }
+}
+
+void TarokVectorEnv::Step(absl::Span<const open_spiel::Action> actions) {
+  SPIEL_CHECK_EQ(actions.size(), num_envs_);
+  std::fill(rewards_.begin(), rewards_.end(), 0);
+  for (int i = 0; i < num_envs_; i++) {
+    TarokState& state = states_[i];
+    state.ApplyAction(actions[i]);
+    dones_[i] = state.IsTerminal();
+    if (dones_[i]) {
+      std::vector<double> returns = state.Returns();
+      std::copy(returns.begin(), returns.end(),
+                rewards_.begin() + i * num_players_);
+      Deal(i);
+    }
+    WriteObservations(i);
+  }
+}
+
+void TarokVectorEnv::Deal(int env_index) {
+  // deals are taken from the game's sequence of deals, the same as states
+  // created by TarokGame::NewInitialTarokState()
+  TarokState& state = states_[env_index];
+  state.ResetForDeal(game_->DealSeed(game_->num_deals_++));
+  // the dummy chance action deals the cards, see TarokState::ChanceOutcomes()
+  state.ApplyAction(0);
+}
+
+void TarokVectorEnv::WriteObservations(int env_index) {
+  const TarokState& state = states_[env_index];
+  open_spiel::Player player = state.CurrentPlayer();
+  current_players_[env_index] = player;
+  uint8_t* mask = &legal_actions_masks_[env_index * num_actions_];
+  std::fill(mask, mask + num_actions_, 0);
+  for (ActionBitmask actions = state.LegalActionsBitmask(); actions != 0;
+       actions &= actions - 1) {
+    mask[__builtin_ctzll(actions)] = 1;
+  }
+  state.InformationStateTensor(
+      player, absl::MakeSpan(&info_state_tensors_[env_index * tensor_size_],
+                             tensor_size_));
+}
+
+int TarokVectorEnv::NumEnvs() const { return num_envs_; }
+
+const TarokState& TarokVectorEnv::State(int env_index) const {
+  return states_.at(env_index);
+}
+
+const std::vector<int>& TarokVectorEnv::CurrentPlayers() const {
+  return current_players_;
+}
+
+const std::vector<uint8_t>& TarokVectorEnv::LegalActionsMasks() const {
+  return legal_actions_masks_;
+}
+
+const std::vector<double>& TarokVectorEnv::Rewards() const { return rewards_; }
+
+const std::vector<uint8_t>& TarokVectorEnv::Dones() const { return dones_; }
+
+const std::vector<float>& TarokVectorEnv::InformationStateTensors() const {
+  return info_state_tensors_;
+}
+
+}  // namespace tarok
@@ -0,0 +1,68 @@
+/* Copyright 2020 Semantic Weights. All rights reserved. */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "absl/types/span.h"
+#include "open_spiel/spiel.h"
+#include "src/game.h"
+#include "src/state.h"
+
+namespace tarok {
+
+// a batch of games that are stepped in lockstep, e.g. for reinforcement
+// learning where stepping each game separately from python costs more than
+// playing the game itself, the states are kept in a single contiguous vector
+// and finished games are dealt new cards in place so that stepping doesn't
+// allocate any states
+//
+// card dealing is applied automatically so each game is always waiting for an
+// action of one of the players, the outputs of the last Reset() or Step() are
+// kept in flat buffers where the values of a game are at the game's index
+// times the size of a single game's values
+class TarokVectorEnv {
+ public:
+  TarokVectorEnv(std::shared_ptr<const TarokGame> game, int num_envs);
+
+  // deals new cards to all games
+  void Reset();
+  // applies the actions (one per game) to the current players of the games,
+  // games that finish are dealt new cards right away, their returns are
+  // recorded in Rewards() and marked in Dones()
+  void Step(absl::Span<const open_spiel::Action> actions);
+
+  int NumEnvs() const;
+  const TarokState& State(int env_index) const;
+  const std::vector<int>& CurrentPlayers() const;
+  // NumDistinctActions() values per game, 1 for legal actions
+  const std::vector<uint8_t>& LegalActionsMasks() const;
+  // NumPlayers() values per game, the returns of games finished by the last
+  // step and zeros for all other games
+  const std::vector<double>& Rewards() const;
+  const std::vector<uint8_t>& Dones() const;
+  // InformationStateTensorSize() values per game from the point of view of
+  // the game's current player
+  const std::vector<float>& InformationStateTensors() const;
+
+ private:
+  void Deal(int env_index);
+  // writes the outputs of the game that don't depend on the last step
+  void WriteObservations(int env_index);
+
+  const std::shared_ptr<const TarokGame> game_;
+  const int num_envs_;
+  const int num_players_;
+  const int num_actions_;
+  const int tensor_size_;
+  std::vector<TarokState> states_;
+  std::vector<int> current_players_;
+  std::vector<uint8_t> legal_actions_masks_;
+  std::vector<double> rewards_;
+  std::vector<uint8_t> dones_;
+  std::vector<float> info_state_tensors_;
+};
+
+}  // namespace tarok
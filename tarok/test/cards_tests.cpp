@@ -1,6 +1,9 @@
 /* Copyright 2020 Semantic Weights. All rights reserved. */
 
 #include <algorithm>
+#include <numeric>
+#include <random>
+#include <vector>
 
 #include "gtest/gtest.h"
 #include "src/cards.h"
@@ -48,27 +51,108 @@ TEST_F(CardsTests, TestPlayersCardsSorted) {
   }
 }
 
+TEST_F(CardsTests, TestDealtCardSetsMatchShuffledDeck) {
+  for (int num_players : {3, 4}) {
+    for (int seed : {0, 42, 634317}) {
+      std::vector<open_spiel::Action> cards(54);
+      std::iota(cards.begin(), cards.end(), 0);
+      Shuffle(&cards, std::mt19937(seed));
+      auto dealt = DealCardSets(num_players, seed);
+      EXPECT_TRUE(std::equal(dealt.talon.begin(), dealt.talon.end(),
+                             cards.begin()));
+      int num_cards_per_player = 48 / num_players;
+      for (int i = 0; i < num_players; i++) {
+        auto begin = cards.begin() + 6 + i * num_cards_per_player;
+        EXPECT_EQ(dealt.players_cards.at(i),
+                  ActionsToCardSet(std::vector<open_spiel::Action>(
+                      begin, begin + num_cards_per_player)));
+      }
+    }
+  }
+}
+
 TEST_F(CardsTests, TestCountCards) {
   auto deck = InitializeCardDeck();
   std::vector<open_spiel::Action> all_card_actions(54);
   std::iota(all_card_actions.begin(), all_card_actions.end(), 0);
-  EXPECT_EQ(CardPoints(all_card_actions, deck), 70);
-  EXPECT_EQ(CardPoints({}, deck), 0);
-  EXPECT_EQ(CardPoints(CardLongNamesToActions({"II"}, deck), deck), 0);
-  EXPECT_EQ(CardPoints(CardLongNamesToActions({"II", "III"}, deck), deck), 1);
-  EXPECT_EQ(CardPoints(CardLongNamesToActions({"Mond"}, deck), deck), 4);
+  EXPECT_EQ(CardPoints(all_card_actions), 70);
+  EXPECT_EQ(CardPoints({}), 0);
+  EXPECT_EQ(CardPoints(CardLongNamesToActions({"II"}, deck)), 0);
+  EXPECT_EQ(CardPoints(CardLongNamesToActions({"II", "III"}, deck)), 1);
+  EXPECT_EQ(CardPoints(CardLongNamesToActions({"Mond"}, deck)), 4);
 
   std::vector<std::string> cards{"Mond", "Jack of Diamonds"};
-  EXPECT_EQ(CardPoints(CardLongNamesToActions(cards, deck), deck), 6);
+  EXPECT_EQ(CardPoints(CardLongNamesToActions(cards, deck)), 6);
 
   cards = {"XIV", "Mond", "Jack of Diamonds"};
-  EXPECT_EQ(CardPoints(CardLongNamesToActions(cards, deck), deck), 6);
+  EXPECT_EQ(CardPoints(CardLongNamesToActions(cards, deck)), 6);
 
   cards = {"XIV", "Mond", "Jack of Diamonds", "Queen of Diamonds"};
-  EXPECT_EQ(CardPoints(CardLongNamesToActions(cards, deck), deck), 9);
+  EXPECT_EQ(CardPoints(CardLongNamesToActions(cards, deck)), 9);
 
   cards = {"II", "Jack of Clubs", "Queen of Clubs", "Mond", "King of Clubs"};
-  EXPECT_EQ(CardPoints(CardLongNamesToActions(cards, deck), deck), 14);
+  EXPECT_EQ(CardPoints(CardLongNamesToActions(cards, deck)), 14);
+
+  // integer rounding has to match counting in batches of three
+  std::mt19937 rng(0);
+  for (int i = 0; i < 1000; i++) {
+    CardSet cards = rng() | (static_cast<CardSet>(rng()) << 32);
+    cards &= kFullCardSet;
+    int points = 0;
+    for (auto const& action : CardSetToActions(cards))
+      points += deck.at(action).points;
+    int num_cards = CardSetSize(cards);
+    int batched_points = points - 2 * (num_cards / 3) - (num_cards % 3 > 0);
+    EXPECT_EQ(CardPoints(cards), batched_points);
+  }
+}
+
+TEST_F(CardsTests, TestCardTable) {
+  // the packed table has to match the card deck
+  auto deck = InitializeCardDeck();
+  CardSet all_points = kEmptyCardSet;
+  for (int action = 0; action < 54; action++) {
+    EXPECT_EQ(CardActionSuit(action), deck.at(action).suit);
+    EXPECT_EQ(CardActionRank(action), deck.at(action).rank);
+    EXPECT_EQ(CardActionPoints(action), deck.at(action).points);
+    EXPECT_TRUE(CardActionInCardSet(
+        action, kCardTable.points_card_sets.at(deck.at(action).points - 1)));
+    EXPECT_EQ(CardDeck().at(action).long_name, deck.at(action).long_name);
+  }
+  for (auto const& points_cards : kCardTable.points_card_sets) {
+    EXPECT_EQ(all_points & points_cards, kEmptyCardSet);
+    all_points |= points_cards;
+  }
+  EXPECT_EQ(all_points, kFullCardSet);
+}
+
+TEST_F(CardsTests, TestCardSets) {
+  auto deck = InitializeCardDeck();
+  for (auto const& player_cards : players_cards_) {
+    CardSet cards = ActionsToCardSet(player_cards);
+    EXPECT_EQ(CardSetSize(cards), player_cards.size());
+    EXPECT_EQ(CardSetToActions(cards), player_cards);
+    EXPECT_EQ(CardPoints(cards), CardPoints(player_cards));
+  }
+
+  // suit card sets should match the card deck
+  CardSet all_suits = kEmptyCardSet;
+  for (auto suit : {CardSuit::kHearts, CardSuit::kDiamonds, CardSuit::kSpades,
+                    CardSuit::kClubs, CardSuit::kTaroks}) {
+    EXPECT_EQ(all_suits & SuitToCardSet(suit), kEmptyCardSet);
+    all_suits |= SuitToCardSet(suit);
+    for (auto const& action : CardSetToActions(SuitToCardSet(suit))) {
+      EXPECT_EQ(deck.at(action).suit, suit);
+    }
+  }
+  EXPECT_EQ(all_suits, kFullCardSet);
+
+  EXPECT_EQ(CardSetToActions(kKingsCardSet),
+            CardLongNamesToActions({"King of Hearts", "King of Diamonds",
+                                    "King of Spades", "King of Clubs"},
+                                   deck));
+  EXPECT_EQ(CardSetToActions(kTrulaCardSet),
+            CardLongNamesToActions({"Pagat", "Mond", "Skis"}, deck));
 }
 
 }  // namespace tarok
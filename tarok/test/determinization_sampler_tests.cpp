@@ -0,0 +1,169 @@
+/* Copyright 2020 Semantic Weights. All rights reserved. */
+
+#include <array>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "src/determinization_sampler.h"
+#include "src/game.h"
+#include "test/state_tests.h"
+#include "test/tarok_utils.h"
+
+namespace tarok {
+
+static CardSet PlayerCardSet(const TarokState& state,
+                             open_spiel::Player player) {
+  return ActionsToCardSet(state.PlayerCards(player));
+}
+
+// undoes all actions of the sampled state but the card dealing and replays
+// them with legality checks, i.e. the sampled cards have to allow every action
+// that was actually taken
+static void ExpectLegalReplay(const TarokState& sampled_state) {
+  auto state = sampled_state.Clone();
+  auto history = state->FullHistory();
+  for (int i = history.size() - 1; i > 0; i--)
+    state->UndoAction(history.at(i).player, history.at(i).action);
+  auto* dealt_state = static_cast<TarokState*>(state.get());
+  for (int i = 0; i < sampled_state.NumPlayers(); i++) {
+    // deals without taroks are redealt
+    EXPECT_NE(PlayerCardSet(*dealt_state, i) & SuitToCardSet(CardSuit::kTaroks),
+              kEmptyCardSet);
+  }
+  for (size_t i = 1; i < history.size(); i++)
+    state->ApplyAction(history.at(i).action);
+  EXPECT_EQ(state->ToString(), sampled_state.ToString());
+  // the hash of sampled states is computed from scratch
+  EXPECT_EQ(static_cast<TarokState&>(*state).Hash(), sampled_state.Hash());
+  EXPECT_TRUE(static_cast<TarokState&>(*state) == sampled_state);
+  for (int i = 0; i < sampled_state.NumPlayers(); i++) {
+    EXPECT_EQ(static_cast<TarokState&>(*state).InformationStateKey(i),
+              sampled_state.InformationStateKey(i));
+  }
+}
+
+static void ExpectConsistentSamples(const TarokState& state,
+                                    open_spiel::Player player,
+                                    std::mt19937* rng) {
+  DeterminizationSampler sampler(state, player);
+  std::vector<float> tensor(state.GetGame()->InformationStateTensorSize());
+  std::vector<float> sampled_tensor(tensor.size());
+  state.InformationStateTensor(player, absl::MakeSpan(tensor));
+  auto sampled_state = sampler.Sample(rng);
+  for (int i = 0; i < 4; i++) {
+    if (i > 0) sampler.Resample(rng, sampled_state.get());
+    EXPECT_EQ(sampled_state->InformationStateString(player),
+              state.InformationStateString(player));
+    EXPECT_EQ(sampled_state->InformationStateKey(player),
+              state.InformationStateKey(player));
+    sampled_state->InformationStateTensor(player,
+                                          absl::MakeSpan(sampled_tensor));
+    EXPECT_EQ(sampled_tensor, tensor);
+    for (int j = 0; j < state.NumPlayers(); j++) {
+      CardSet cards = PlayerCardSet(*sampled_state, j);
+      EXPECT_EQ(CardSetSize(cards), CardSetSize(PlayerCardSet(state, j)));
+      EXPECT_EQ(cards & sampler.ExcludedCards(j), kEmptyCardSet);
+    }
+    if (state.CurrentPlayer() == player) {
+      EXPECT_EQ(sampled_state->LegalActions(), state.LegalActions());
+    }
+    ExpectLegalReplay(*sampled_state);
+  }
+}
+
+static void SampleInRandomGames(int num_players) {
+  auto game = NewTarokGame(open_spiel::GameParameters(
+      {{"num_players", open_spiel::GameParameter(num_players)},
+       {"seed", open_spiel::GameParameter(0)}}));
+  std::mt19937 rng(0);
+  for (int deal = 0; deal < 20; deal++) {
+    auto state = game->NewInitialTarokState(deal);
+    state->ApplyAction(kDealCardsAction);
+    while (!state->IsTerminal()) {
+      if (rng() % 4 == 0) {
+        for (int i = 0; i < num_players; i++)
+          ExpectConsistentSamples(*state, i, &rng);
+      }
+      auto legal_actions = state->LegalActions();
+      state->ApplyAction(legal_actions.at(rng() % legal_actions.size()));
+    }
+  }
+}
+
+TEST_F(TarokStateTests, TestDeterminizationSamplerWithThreePlayers) {
+  SampleInRandomGames(3);
+}
+
+TEST_F(TarokStateTests, TestDeterminizationSamplerWithFourPlayers) {
+  SampleInRandomGames(4);
+}
+
+TEST_F(TarokStateTests, TestDeterminizationSamplerRespectsVoids) {
+  // klop implies the most constraints since players have to beat the trick
+  auto state = StateAfterActions(
+      open_spiel::GameParameters({{"seed", open_spiel::GameParameter(0)}}),
+      {kDealCardsAction, kBidPassAction, kBidPassAction, kBidKlopAction});
+  std::mt19937 rng(0);
+  int num_tricks = 0;
+  while (!state->IsTerminal() && num_tricks < 8) {
+    auto legal_actions = state->LegalActions();
+    state->ApplyAction(legal_actions.at(rng() % legal_actions.size()));
+    if (state->TrickCards().empty()) num_tricks++;
+  }
+  for (open_spiel::Player player = 0; player < 3; player++) {
+    DeterminizationSampler sampler(*state, player);
+    EXPECT_EQ(sampler.HiddenCards() & PlayerCardSet(*state, player),
+              kEmptyCardSet);
+    for (open_spiel::Player other = 0; other < 3; other++) {
+      if (other == player) continue;
+      EXPECT_NE(sampler.HiddenCards() & PlayerCardSet(*state, other),
+                kEmptyCardSet);
+      // the actual cards are never excluded
+      EXPECT_EQ(sampler.ExcludedCards(other) & PlayerCardSet(*state, other),
+                kEmptyCardSet);
+    }
+  }
+}
+
+TEST_F(TarokStateTests, TestDeterminizationSamplerDistribution) {
+  auto state = StateAfterActions(
+      open_spiel::GameParameters({{"seed", open_spiel::GameParameter(0)}}),
+      {kDealCardsAction});
+  DeterminizationSampler sampler(*state, 0);
+  EXPECT_EQ(CardSetSize(sampler.HiddenCards()), 54 - 16);
+  std::mt19937 rng(0);
+  std::array<int, 3> num_player_cards{};
+  int num_talon_taroks = 0;
+  std::set<CardSet> first_player_cards;
+  auto sampled_state = sampler.Sample(&rng);
+  for (int i = 0; i < 2000; i++) {
+    sampler.Resample(&rng, sampled_state.get());
+    first_player_cards.insert(PlayerCardSet(*sampled_state, 1));
+    for (open_spiel::Player player = 1; player < 3; player++) {
+      num_player_cards.at(player) +=
+          CardSetSize(PlayerCardSet(*sampled_state, player) &
+                      sampler.HiddenCards() & SuitToCardSet(CardSuit::kHearts));
+    }
+    num_talon_taroks += CardSetSize(ActionsToCardSet(sampled_state->Talon()) &
+                                    SuitToCardSet(CardSuit::kTaroks));
+  }
+  EXPECT_EQ(first_player_cards.size(), 2000);
+  // every hidden card is held by each of the other players with probability
+  // 16 / 38 and is in talon with probability 6 / 38, apart from the negligible
+  // effect of rejecting deals in which a player has no taroks
+  int num_hidden_hearts = CardSetSize(sampler.HiddenCards() &
+                                      SuitToCardSet(CardSuit::kHearts));
+  for (open_spiel::Player player = 1; player < 3; player++) {
+    EXPECT_NEAR(num_player_cards.at(player) / (2000.0 * num_hidden_hearts),
+                16.0 / 38, 0.02);
+  }
+  int num_hidden_taroks = CardSetSize(sampler.HiddenCards() &
+                                      SuitToCardSet(CardSuit::kTaroks));
+  EXPECT_NEAR(num_talon_taroks / 2000.0, num_hidden_taroks * 6.0 / 38, 0.08);
+}
+
+}  // namespace tarok
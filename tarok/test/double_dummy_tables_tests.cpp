@@ -0,0 +1,133 @@
+/* Copyright 2020 Semantic Weights. All rights reserved. */
+
+#include <memory>
+#include <sstream>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "src/double_dummy.h"
+#include "src/double_dummy_tables.h"
+#include "src/game.h"
+#include "test/state_tests.h"
+
+namespace tarok {
+
+static std::shared_ptr<const TarokGame> NewGame(int num_players) {
+  return NewTarokGame(open_spiel::GameParameters(
+      {{"num_players", open_spiel::GameParameter(num_players)},
+       {"seed", open_spiel::GameParameter(0)}}));
+}
+
+TEST_F(TarokStateTests, TestDoubleDummyTableEntries) {
+  ThreadPool pool(2);
+  auto tables = DoubleDummyTables(*NewGame(3), 5, 1, 1, &pool);
+  ASSERT_EQ(tables.size(), 1);
+  EXPECT_EQ(tables.at(0).deal_index, 5);
+  // only the forehand can play klop and three, solo contracts are only played
+  // by four players
+  std::vector<std::vector<int>> contracts{{0, 1, 2, 3, 7, 8, 9, 10, 11},
+                                          {2, 3, 7, 8, 9, 10, 11},
+                                          {2, 3, 7, 8, 9, 10, 11}};
+  std::vector<std::vector<int>> table_contracts(3);
+  for (auto const& entry : tables.at(0).entries) {
+    table_contracts.at(entry.declarer).push_back(entry.contract);
+    EXPECT_EQ(entry.called_king, open_spiel::kInvalidAction);
+    // every search is stopped right away so nothing is proven about the
+    // values
+    EXPECT_EQ(entry.won, 0);
+    EXPECT_LT(entry.lower, entry.upper);
+    EXPECT_EQ(entry.heuristic_discards, entry.talon_set != -1);
+  }
+  EXPECT_EQ(table_contracts, contracts);
+}
+
+TEST_F(TarokStateTests, TestDoubleDummyTableCalledKings) {
+  ThreadPool pool(2);
+  auto game = NewGame(4);
+  auto table = DoubleDummyTables(*game, 0, 1, 1, &pool).at(0);
+  auto state = game->NewInitialTarokState(0);
+  state->ApplyAction(kDealCardsAction);
+  for (int i = 0; i < 3; i++) state->ApplyAction(kBidPassAction);
+  state->ApplyAction(kBidThreeAction);
+  std::vector<open_spiel::Action> called_kings;
+  for (auto const& entry : table.entries) {
+    bool needs_king_calling = entry.contract >= 1 && entry.contract <= 3;
+    EXPECT_EQ(entry.called_king != open_spiel::kInvalidAction,
+              needs_king_calling);
+    if (entry.declarer == 0 && entry.contract == kBidThreeAction - 1)
+      called_kings.push_back(entry.called_king);
+  }
+  EXPECT_EQ(called_kings, state->LegalActions());
+}
+
+TEST_F(TarokStateTests, TestDoubleDummyTableValues) {
+  auto game = NewGame(3);
+  ThreadPool pool(3);
+  auto tables = DoubleDummyTables(*game, 0, 2, 20000, &pool);
+  DoubleDummySolver solver;
+  int num_solved_entries = 0;
+  int num_won_entries = 0;
+  for (auto const& table : tables) {
+    for (auto const& entry : table.entries) {
+      EXPECT_LE(entry.lower, entry.upper);
+      num_won_entries += entry.won != 0;
+      if (entry.lower != entry.upper && entry.won == 0) continue;
+      // contracts without talon exchange are solved right after bidding
+      auto state = game->NewInitialTarokState(table.deal_index);
+      state->ApplyAction(kDealCardsAction);
+      while (state->CurrentGamePhase() == GamePhase::kBidding) {
+        state->ApplyAction(state->CurrentPlayer() == entry.declarer
+                               ? entry.contract + 1
+                               : kBidPassAction);
+      }
+      if (state->CurrentGamePhase() != GamePhase::kTricksPlaying) {
+        EXPECT_GE(entry.talon_set, 0);
+        EXPECT_TRUE(entry.heuristic_discards);
+        continue;
+      }
+      EXPECT_EQ(entry.talon_set, -1);
+      EXPECT_FALSE(entry.heuristic_discards);
+      if (entry.won != 0) {
+        EXPECT_EQ(entry.won,
+                  solver.SolveContractWon(*state, entry.declarer).value);
+      }
+      if (entry.lower == entry.upper) {
+        num_solved_entries++;
+        EXPECT_EQ(entry.lower, solver.Solve(*state, entry.declarer).value);
+      }
+    }
+  }
+  EXPECT_GT(num_solved_entries, 0);
+  // whether the declarer wins is solved more often than the return
+  EXPECT_GT(num_won_entries, num_solved_entries);
+
+  // the same tables are computed regardless of the number of threads
+  ThreadPool single_thread_pool(1);
+  auto single_thread_tables =
+      DoubleDummyTables(*game, 0, 2, 20000, &single_thread_pool);
+  for (size_t i = 0; i < tables.size(); i++) {
+    EXPECT_EQ(tables.at(i).entries, single_thread_tables.at(i).entries);
+  }
+}
+
+TEST_F(TarokStateTests, TestDoubleDummyTablesWriteAndRead) {
+  std::vector<DoubleDummyTable> tables{
+      {3,
+       {{0, 0, -1, -1, 0, false, -70, -70},
+        {2, 1, 29, 1, 1, true, 300, 300}}},
+      {1LL << 40, {{11, 2, -1, -1, -1, false, -1000, 1000}}},
+      {7, {}}};
+  std::stringstream stream;
+  for (auto const& table : tables) WriteDoubleDummyTable(table, &stream);
+  EXPECT_EQ(stream.str().size(), 3 * 9 + 3 * 10);
+
+  DoubleDummyTable table;
+  for (auto const& expected_table : tables) {
+    ASSERT_TRUE(ReadDoubleDummyTable(&stream, &table));
+    EXPECT_EQ(table.deal_index, expected_table.deal_index);
+    EXPECT_EQ(table.entries, expected_table.entries);
+  }
+  EXPECT_FALSE(ReadDoubleDummyTable(&stream, &table));
+}
+
+}  // namespace tarok
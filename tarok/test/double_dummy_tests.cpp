@@ -0,0 +1,288 @@
+/* Copyright 2020 Semantic Weights. All rights reserved. */
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "src/double_dummy.h"
+#include "src/game.h"
+#include "test/state_tests.h"
+
+namespace tarok {
+
+// plain minimax over the public interface without any pruning where values of
+// terminal states are given by terminal_value
+template <typename TerminalValue>
+static int Minimax(const TarokState& state, const std::vector<bool>& maximizing,
+                   const TerminalValue& terminal_value) {
+  if (state.IsTerminal()) return terminal_value(state);
+  bool maximize = maximizing.at(state.CurrentPlayer());
+  int value = maximize ? -1000 : 1000;
+  for (auto const& action : state.LegalActions()) {
+    auto child = state.Clone();
+    child->ApplyAction(action);
+    int child_value = Minimax(static_cast<TarokState&>(*child), maximizing,
+                              terminal_value);
+    value = maximize ? std::max(value, child_value)
+                     : std::min(value, child_value);
+  }
+  return value;
+}
+
+static int Minimax(const TarokState& state, open_spiel::Player player,
+                   const std::vector<bool>& maximizing) {
+  return Minimax(state, maximizing, [player](const TarokState& state) {
+    return static_cast<int>(state.Returns().at(player));
+  });
+}
+
+// whether the declarer's team won the contract in a finished game, see
+// DoubleDummySolver::SolveContractWon()
+static bool DeclarerTeamWon(const TarokState& state,
+                            const std::vector<bool>& declarer_team) {
+  CardSet collected = kEmptyCardSet;
+  for (size_t i = 0; i < declarer_team.size(); i++) {
+    if (declarer_team.at(i)) collected |= state.CollectedCardSet(i);
+  }
+  switch (state.SelectedContractName()) {
+    case ContractName::kBeggar:
+    case ContractName::kOpenBeggar:
+      return collected == kEmptyCardSet;
+    case ContractName::kColourValatWithout:
+    case ContractName::kValatWithout:
+      return CardSetSize(collected) == 48;
+    default:
+      return CardPoints(collected) > 35;
+  }
+}
+
+static void ExpectSolvedValuesMatchMinimax(const TarokState& state,
+                                           open_spiel::Player player,
+                                           const std::vector<bool>& maximizing,
+                                           DoubleDummySolver* solver) {
+  int value = Minimax(state, player, maximizing);
+  auto result = solver->Solve(state, player);
+  EXPECT_EQ(result.value, value);
+  auto best_child = state.Clone();
+  best_child->ApplyAction(result.best_action);
+  EXPECT_EQ(
+      Minimax(static_cast<TarokState&>(*best_child), player, maximizing),
+      value);
+
+  for (auto const& [action, action_value] :
+       solver->ActionValues(state, player)) {
+    auto child = state.Clone();
+    child->ApplyAction(action);
+    EXPECT_EQ(action_value,
+              Minimax(static_cast<TarokState&>(*child), player, maximizing));
+  }
+}
+
+// team holds the players of the declarer's team, the player's team maximizes
+// whether it wins
+static void ExpectContractWonMatchesMinimax(const TarokState& state,
+                                            open_spiel::Player player,
+                                            const std::vector<bool>& team,
+                                            DoubleDummySolver* solver) {
+  auto terminal_value = [&team, player](const TarokState& state) {
+    return DeclarerTeamWon(state, team) == team.at(player) ? 1 : -1;
+  };
+  std::vector<bool> maximizing(team.size());
+  for (size_t i = 0; i < team.size(); i++)
+    maximizing.at(i) = team.at(i) == team.at(player);
+  int value = Minimax(state, maximizing, terminal_value);
+  auto result = solver->SolveContractWon(state, player);
+  EXPECT_EQ(result.value, value);
+  auto best_child = state.Clone();
+  best_child->ApplyAction(result.best_action);
+  EXPECT_EQ(Minimax(static_cast<TarokState&>(*best_child), maximizing,
+                    terminal_value),
+            value);
+}
+
+// checks whether the game can go on past the current trick
+static bool CanContinueAfterTrick(const TarokState& state) {
+  if (state.IsTerminal()) return false;
+  if (state.CurrentGamePhase() != GamePhase::kTricksPlaying ||
+      state.TrickCards().empty()) {
+    return true;
+  }
+  for (auto const& action : state.LegalActions()) {
+    if (CanContinueAfterTrick(static_cast<TarokState&>(*state.Child(action))))
+      return true;
+  }
+  return false;
+}
+
+// lets the forehand declare the contract, plays randomly until every player
+// holds the given number of cards and compares the solver with minimax from
+// the perspective of both teams, both at the trick boundary and within a trick
+static void SolveRandomEndgames(int num_players, size_t num_cards) {
+  auto game = NewTarokGame(open_spiel::GameParameters(
+      {{"num_players", open_spiel::GameParameter(num_players)},
+       {"seed", open_spiel::GameParameter(0)}}));
+  std::mt19937 rng(0);
+  DoubleDummySolver solver;
+
+  for (int contract = 0; contract < 12; contract++) {
+    // solo contracts are only played by four players
+    if (num_players == 3 && contract >= kBidSoloThreeAction - 1 &&
+        contract <= kBidSoloOneAction - 1) {
+      continue;
+    }
+    int num_endgames = 0;
+    for (int deal = 0; deal < 300 && num_endgames < 4; deal++) {
+      auto state = game->NewInitialTarokState(deal);
+      state->ApplyAction(kDealCardsAction);
+      while (state->CurrentPlayer() != 0) state->ApplyAction(kBidPassAction);
+      state->ApplyAction(contract + 1);
+      ContractName contract_name = state->SelectedContractName();
+
+      // the declarer is the forehand, the partner holds the called king
+      std::vector<bool> declarer_team(num_players, false);
+      declarer_team.at(0) = true;
+      // actions that would finish the game with the current trick are avoided
+      // where possible so that endgames of beggar and valat contracts are
+      // reached as well
+      auto play_random_action = [&]() {
+        std::vector<open_spiel::Action> legal_actions;
+        for (auto const& action : state->LegalActions()) {
+          if (CanContinueAfterTrick(
+                  static_cast<TarokState&>(*state->Child(action))))
+            legal_actions.push_back(action);
+        }
+        if (legal_actions.empty()) legal_actions = state->LegalActions();
+        open_spiel::Action action = legal_actions.at(rng() %
+                                                     legal_actions.size());
+        if (state->CurrentGamePhase() == GamePhase::kKingCalling) {
+          for (int i = 1; i < num_players; i++) {
+            auto cards = state->PlayerCards(i);
+            if (std::find(cards.begin(), cards.end(), action) != cards.end())
+              declarer_team.at(i) = true;
+          }
+        }
+        state->ApplyAction(action);
+      };
+      while (!state->IsTerminal() &&
+             (state->CurrentGamePhase() != GamePhase::kTricksPlaying ||
+              !state->TrickCards().empty() ||
+              state->PlayerCards(0).size() > num_cards)) {
+        play_random_action();
+      }
+      if (state->IsTerminal()) continue;
+      num_endgames++;
+
+      for (int i = 0; i < 2; i++) {
+        for (open_spiel::Player player : {0, 1}) {
+          std::vector<bool> maximizing(num_players);
+          for (int j = 0; j < num_players; j++) {
+            maximizing.at(j) = contract_name == ContractName::kKlop
+                                   ? j == player
+                                   : declarer_team.at(j) ==
+                                         declarer_team.at(player);
+          }
+          ExpectSolvedValuesMatchMinimax(*state, player, maximizing, &solver);
+          if (contract_name != ContractName::kKlop) {
+            ExpectContractWonMatchesMinimax(*state, player, declarer_team,
+                                            &solver);
+          }
+        }
+        // the second time within the trick
+        play_random_action();
+        if (state->IsTerminal()) break;
+      }
+    }
+    EXPECT_EQ(num_endgames, 4);
+  }
+}
+
+TEST_F(TarokStateTests, TestDoubleDummyWithThreePlayers) {
+  SolveRandomEndgames(3, 4);
+}
+
+TEST_F(TarokStateTests, TestDoubleDummyWithFourPlayers) {
+  SolveRandomEndgames(4, 3);
+}
+
+// solves the whole deal of three players once the tricks playing starts and
+// follows the principal variation to the end, solving times vary a lot
+// between deals and contracts so the deals are chosen to be solved within a
+// bounded number of nodes
+static void SolveFullDeal(int deal, ContractName contract_name) {
+  auto game = NewTarokGame(open_spiel::GameParameters(
+      {{"num_players", open_spiel::GameParameter(3)},
+       {"seed", open_spiel::GameParameter(0)}}));
+  auto state = game->NewInitialTarokState(deal);
+  state->ApplyAction(kDealCardsAction);
+  while (state->CurrentPlayer() != 0) state->ApplyAction(kBidPassAction);
+  state->ApplyAction(static_cast<int>(contract_name) + 1);
+  while (state->CurrentGamePhase() != GamePhase::kTricksPlaying)
+    state->ApplyAction(state->LegalActions().front());
+  EXPECT_EQ(state->PlayerCards(0).size(), 16);
+
+  DoubleDummySolver solver(1000000);
+  auto result = solver.Solve(*state, 0);
+  EXPECT_TRUE(result.solved);
+  while (!state->IsTerminal()) {
+    auto next_result = solver.Solve(*state, 0);
+    EXPECT_TRUE(next_result.solved);
+    EXPECT_EQ(next_result.value, result.value);
+    state->ApplyAction(next_result.best_action);
+  }
+  EXPECT_EQ(state->Returns().at(0), result.value);
+}
+
+TEST_F(TarokStateTests, TestDoubleDummyFullDealWithThreePlayers) {
+  SolveFullDeal(0, ContractName::kBeggar);
+  SolveFullDeal(1, ContractName::kColourValatWithout);
+}
+
+TEST_F(TarokStateTests, TestDoubleDummyInFinishedGame) {
+  auto game = NewTarokGame(
+      open_spiel::GameParameters({{"seed", open_spiel::GameParameter(0)}}));
+  auto state = game->NewInitialTarokState();
+  std::mt19937 rng(0);
+  while (!state->IsTerminal()) {
+    auto legal_actions = state->LegalActions();
+    state->ApplyAction(legal_actions.at(rng() % legal_actions.size()));
+  }
+  DoubleDummySolver solver;
+  auto result = solver.Solve(*state, 0);
+  EXPECT_EQ(result.value, state->Returns().at(0));
+  EXPECT_EQ(result.best_action, open_spiel::kInvalidAction);
+}
+
+TEST_F(TarokStateTests, TestDoubleDummyBoundsWithNodeLimit) {
+  auto game = NewTarokGame(
+      open_spiel::GameParameters({{"seed", open_spiel::GameParameter(0)}}));
+  auto state = game->NewInitialTarokState();
+  state->ApplyAction(kDealCardsAction);
+  while (state->CurrentPlayer() != 0) state->ApplyAction(kBidPassAction);
+  state->ApplyAction(kBidThreeAction);
+  std::mt19937 rng(0);
+  while (state->CurrentGamePhase() != GamePhase::kTricksPlaying ||
+         !state->TrickCards().empty() || state->PlayerCards(0).size() > 6) {
+    auto legal_actions = state->LegalActions();
+    state->ApplyAction(legal_actions.at(rng() % legal_actions.size()));
+  }
+  int value = DoubleDummySolver().Solve(*state, 0).value;
+
+  // stopped searches still bound the value
+  for (int64_t max_nodes : {1, 100, 1000, 10000}) {
+    DoubleDummySolver solver(max_nodes);
+    auto result = solver.Solve(*state, 0);
+    EXPECT_LE(result.lower, value);
+    EXPECT_GE(result.upper, value);
+    if (max_nodes == 1) {
+      EXPECT_FALSE(result.solved);
+    }
+    if (result.solved) {
+      EXPECT_EQ(result.lower, value);
+      EXPECT_EQ(result.upper, value);
+    }
+  }
+}
+
+}  // namespace tarok
@@ -1,5 +1,8 @@
 /* Copyright 2020 Semantic Weights. All rights reserved. */
 
+#include <thread>
+#include <vector>
+
 #include "gtest/gtest.h"
 #include "src/game.h"
 
@@ -35,4 +38,49 @@ TEST(TarokGameTests, TestCardDeckShufflingSeed) {
   EXPECT_EQ(state2->PlayerCards(0), state4->PlayerCards(0));
 }
 
+TEST(TarokGameTests, TestDealsAreReproducibleFromTheirIndex) {
+  auto game = NewTarokGame(
+      open_spiel::GameParameters({{"seed", open_spiel::GameParameter(0)}}));
+  auto state1 = game->NewInitialTarokState();
+  state1->ApplyAction(0);
+  auto state2 = game->NewInitialTarokState();
+  state2->ApplyAction(0);
+
+  // the deal doesn't depend on the number of states created before
+  auto state3 = game->NewInitialTarokState(1);
+  state3->ApplyAction(0);
+  auto state4 = game->NewInitialTarokState(0);
+  state4->ApplyAction(0);
+  EXPECT_EQ(state1->PlayerCards(0), state4->PlayerCards(0));
+  EXPECT_EQ(state2->PlayerCards(0), state3->PlayerCards(0));
+  EXPECT_EQ(state1->Talon(), state4->Talon());
+  EXPECT_EQ(state2->Talon(), state3->Talon());
+}
+
+TEST(TarokGameTests, TestDealingFromMultipleThreads) {
+  auto game = NewTarokGame(
+      open_spiel::GameParameters({{"seed", open_spiel::GameParameter(0)}}));
+  constexpr int kNumThreads = 4;
+  constexpr int kNumDealsPerThread = 100;
+  std::vector<std::vector<open_spiel::Action>> talons(kNumThreads *
+                                                      kNumDealsPerThread);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kNumThreads; i++) {
+    threads.emplace_back([&game, &talons, i]() {
+      for (size_t j = i; j < talons.size(); j += kNumThreads) {
+        auto state = game->NewInitialTarokState(j);
+        state->ApplyAction(0);
+        talons.at(j) = state->Talon();
+      }
+    });
+  }
+  for (auto& thread : threads) thread.join();
+
+  for (size_t i = 0; i < talons.size(); i++) {
+    auto state = game->NewInitialTarokState(i);
+    state->ApplyAction(0);
+    EXPECT_EQ(talons.at(i), state->Talon());
+  }
+}
+
 }  // namespace tarok
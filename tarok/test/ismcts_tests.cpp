@@ -0,0 +1,133 @@
+/* Copyright 2020 Semantic Weights. All rights reserved. */
+
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "src/game.h"
+#include "src/ismcts.h"
+#include "test/state_tests.h"
+#include "test/tarok_utils.h"
+
+namespace tarok {
+
+static int SumOfRootVisits(const IsmctsBot& bot) {
+  int sum = 0;
+  for (auto const& [action, visits] : bot.RootVisitCounts()) sum += visits;
+  return sum;
+}
+
+static bool IsLegalAction(const TarokState& state, open_spiel::Action action) {
+  return state.LegalActionsBitmask() & (ActionBitmask{1} << action);
+}
+
+// the bot plays for player 0 and all other players play randomly
+static void PlayAgainstRandomPlayers(int num_players,
+                                     const IsmctsConfig& config) {
+  auto game = NewTarokGame(open_spiel::GameParameters(
+      {{"num_players", open_spiel::GameParameter(num_players)},
+       {"seed", open_spiel::GameParameter(0)}}));
+  std::mt19937 rng(0);
+  IsmctsBot bot(config);
+  for (int deal = 0; deal < 2; deal++) {
+    auto state = game->NewInitialTarokState(deal);
+    state->ApplyAction(kDealCardsAction);
+    while (!state->IsTerminal()) {
+      auto legal_actions = state->LegalActions();
+      if (state->CurrentPlayer() != 0) {
+        state->ApplyAction(legal_actions.at(rng() % legal_actions.size()));
+        continue;
+      }
+      open_spiel::Action action = bot.Step(*state);
+      EXPECT_TRUE(IsLegalAction(*state, action));
+      if (legal_actions.size() > 1) {
+        EXPECT_EQ(bot.NumIterations(), config.num_iterations);
+        EXPECT_GE(SumOfRootVisits(bot), config.num_iterations);
+      }
+      state->ApplyAction(action);
+    }
+  }
+}
+
+TEST_F(TarokStateTests, TestIsmctsWithThreePlayers) {
+  IsmctsConfig config;
+  config.num_iterations = 100;
+  PlayAgainstRandomPlayers(3, config);
+}
+
+TEST_F(TarokStateTests, TestIsmctsWithFourPlayers) {
+  IsmctsConfig config;
+  config.num_iterations = 100;
+  PlayAgainstRandomPlayers(4, config);
+}
+
+TEST_F(TarokStateTests, TestIsmctsWithTreeParallelism) {
+  IsmctsConfig config;
+  config.num_iterations = 100;
+  config.num_threads = 2;
+  config.parallelism = IsmctsParallelism::kTree;
+  PlayAgainstRandomPlayers(3, config);
+}
+
+TEST_F(TarokStateTests, TestIsmctsWithRootParallelism) {
+  IsmctsConfig config;
+  config.num_iterations = 100;
+  config.num_threads = 2;
+  config.parallelism = IsmctsParallelism::kRoot;
+  PlayAgainstRandomPlayers(3, config);
+}
+
+TEST_F(TarokStateTests, TestIsmctsReusesTree) {
+  // klop is played until the last trick
+  auto params = open_spiel::GameParameters(
+      {{"num_players", open_spiel::GameParameter(3)},
+       {"seed", open_spiel::GameParameter(0)}});
+  auto state = StateAfterActions(params, {kDealCardsAction, kBidPassAction,
+                                          kBidPassAction, kBidKlopAction});
+  std::mt19937 rng(0);
+  // plays randomly until player 0 has to choose between multiple actions
+  auto play_until_choice = [&]() {
+    do {
+      auto legal_actions = state->LegalActions();
+      state->ApplyAction(legal_actions.at(rng() % legal_actions.size()));
+    } while (state->CurrentPlayer() != 0 || state->LegalActions().size() < 2);
+  };
+  // the tree covers most of the remaining actions in the last few tricks
+  while (state->PlayerCards(0).size() > 5) play_until_choice();
+
+  IsmctsConfig config;
+  config.num_iterations = 1000;
+  IsmctsBot bot(config);
+  config.reuse_tree = false;
+  IsmctsBot fresh_bot(config);
+  state->ApplyAction(bot.Step(*state));
+  EXPECT_EQ(SumOfRootVisits(bot), 1000);
+  play_until_choice();
+  bot.Step(*state);
+  fresh_bot.Step(*state);
+  EXPECT_GT(SumOfRootVisits(bot), 1000);
+  EXPECT_EQ(SumOfRootVisits(fresh_bot), 1000);
+
+  // trees are dropped for states that don't continue the searched game
+  auto other_state = StateAfterActions(params, {kDealCardsAction});
+  other_state->ApplyAction(kBidPassAction);
+  bot.Step(*other_state);
+  EXPECT_EQ(SumOfRootVisits(bot), 1000);
+}
+
+TEST_F(TarokStateTests, TestIsmctsWithTimeLimit) {
+  auto state = StateAfterActions(
+      open_spiel::GameParameters({{"seed", open_spiel::GameParameter(0)}}),
+      {kDealCardsAction});
+  IsmctsConfig config;
+  config.num_iterations = 0;
+  config.max_seconds = 0.02;
+  IsmctsBot bot(config);
+  EXPECT_TRUE(IsLegalAction(*state, bot.Step(*state)));
+  EXPECT_GT(bot.NumIterations(), 0);
+  EXPECT_EQ(SumOfRootVisits(bot), bot.NumIterations());
+}
+
+}  // namespace tarok
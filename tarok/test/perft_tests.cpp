@@ -0,0 +1,96 @@
+/* Copyright 2020 Semantic Weights. All rights reserved. */
+
+#include <memory>
+
+#include "gtest/gtest.h"
+#include "src/game.h"
+#include "src/perft.h"
+#include "test/state_tests.h"
+#include "test/tarok_utils.h"
+
+namespace tarok {
+
+// counts nodes through the public interface, i.e. by cloning the state and
+// applying checked actions at every node
+static void CountNodes(const TarokState& state, int depth, int max_depth,
+                       GamePhase last_game_phase, PerftCounts* counts) {
+  counts->nodes.at(depth).at(static_cast<int>(state.CurrentGamePhase()))++;
+  if (depth == max_depth || state.IsTerminal() ||
+      state.CurrentGamePhase() > last_game_phase) {
+    return;
+  }
+  for (auto const& action : state.LegalActions()) {
+    auto child = state.Clone();
+    child->ApplyAction(action);
+    CountNodes(static_cast<TarokState&>(*child), depth + 1, max_depth,
+               last_game_phase, counts);
+  }
+}
+
+static void ExpectPerftMatchesCountedNodes(
+    const TarokState& state, int depth,
+    GamePhase last_game_phase = GamePhase::kFinished) {
+  PerftCounts counts;
+  counts.nodes.resize(depth + 1);
+  CountNodes(state, 0, depth, last_game_phase, &counts);
+  EXPECT_EQ(Perft(state, depth, last_game_phase).nodes, counts.nodes);
+}
+
+TEST_F(TarokStateTests, TestPerftInBidding) {
+  auto state = StateAfterActions(
+      open_spiel::GameParameters({{"seed", open_spiel::GameParameter(634317)}}),
+      {kDealCardsAction});
+  auto counts = Perft(*state, 2);
+  EXPECT_EQ(counts.Nodes(0), 1);
+  EXPECT_EQ(counts.Nodes(0, GamePhase::kBidding), 1);
+  EXPECT_EQ(counts.Nodes(1), state->LegalActions().size());
+  ExpectPerftMatchesCountedNodes(*state, 5);
+}
+
+TEST_F(TarokStateTests, TestPerftWithFourPlayers) {
+  auto state = StateAfterActions(
+      open_spiel::GameParameters({{"num_players", open_spiel::GameParameter(4)},
+                                  {"seed", open_spiel::GameParameter(0)}}),
+      {kDealCardsAction, kBidPassAction, kBidPassAction, kBidPassAction});
+  // the forehand's bid leads to king calling and talon exchange
+  auto counts = Perft(*state, 3);
+  EXPECT_GT(counts.Nodes(1, GamePhase::kKingCalling), 0);
+  EXPECT_GT(counts.Nodes(2, GamePhase::kTalonExchange), 0);
+  ExpectPerftMatchesCountedNodes(*state, 4);
+}
+
+TEST_F(TarokStateTests, TestPerftInTricksPlaying) {
+  auto state = StateAfterActions(
+      open_spiel::GameParameters({{"seed", open_spiel::GameParameter(634317)}}),
+      {kDealCardsAction, kBidPassAction, kBidPassAction, kBidKlopAction});
+  ExpectPerftMatchesCountedNodes(*state, 4);
+}
+
+TEST_F(TarokStateTests, TestPerftStopsAtLastGamePhase) {
+  auto state = StateAfterActions(
+      open_spiel::GameParameters({{"seed", open_spiel::GameParameter(634317)}}),
+      {kDealCardsAction, kBidPassAction, kBidPassAction});
+  // the tree is exhausted once all talon exchanges are done, i.e. long before
+  // any tricks could have been played
+  auto counts = Perft(*state, 20, GamePhase::kTalonExchange);
+  EXPECT_EQ(counts.Nodes(20), 0);
+  EXPECT_GT(counts.Nodes(1, GamePhase::kTricksPlaying), 0);
+  ExpectPerftMatchesCountedNodes(*state, 20, GamePhase::kTalonExchange);
+}
+
+TEST_F(TarokStateTests, TestParallelPerft) {
+  auto game = NewTarokGame(
+      open_spiel::GameParameters({{"seed", open_spiel::GameParameter(0)}}));
+  PerftCounts counts;
+  for (int i = 0; i < 8; i++) {
+    auto state = game->NewInitialTarokState(i);
+    state->ApplyAction(kDealCardsAction);
+    counts.Add(Perft(*state, 4));
+  }
+  EXPECT_EQ(ParallelPerft(*game, 0, 8, 4, GamePhase::kFinished, 1).nodes,
+            counts.nodes);
+  EXPECT_EQ(ParallelPerft(*game, 0, 8, 4, GamePhase::kFinished, 3).nodes,
+            counts.nodes);
+}
+
+}  // namespace tarok
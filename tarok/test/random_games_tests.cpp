@@ -0,0 +1,63 @@
+/* Copyright 2020 Semantic Weights. All rights reserved. */
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "src/game.h"
+#include "src/random_games.h"
+#include "test/state_tests.h"
+#include "test/tarok_utils.h"
+
+namespace tarok {
+
+// recorded histories have to replay to the recorded outcomes
+static void ExpectReplayableGames(const RandomGamesResult& result, int seed) {
+  auto game = NewTarokGame(open_spiel::GameParameters(
+      {{"num_players", open_spiel::GameParameter(result.num_players)},
+       {"seed", open_spiel::GameParameter(seed)}}));
+  for (int i = 0; i < result.num_games; i++) {
+    auto state = game->NewInitialTarokState(i);
+    state->ApplyAction(kDealCardsAction);
+    for (int j = 0; j < result.max_game_length; j++) {
+      open_spiel::Action action =
+          result.histories.at(i * result.max_game_length + j);
+      if (j >= result.game_lengths.at(i)) {
+        EXPECT_EQ(action, open_spiel::kInvalidAction);
+        continue;
+      }
+      state->ApplyAction(action);
+    }
+    EXPECT_TRUE(state->IsTerminal());
+    EXPECT_EQ(state->SelectedContractName(), result.contracts.at(i));
+    EXPECT_EQ(state->Returns(),
+              std::vector<double>(
+                  result.returns.begin() + i * result.num_players,
+                  result.returns.begin() + (i + 1) * result.num_players));
+  }
+}
+
+TEST_F(TarokStateTests, TestRandomGamesWithThreePlayers) {
+  // chunks of games don't line up with the number of games
+  auto result = PlayRandomGames(300, 0, 1, 3, true);
+  EXPECT_EQ(result.contracts.size(), 300);
+  EXPECT_EQ(result.returns.size(), 300 * 3);
+  ExpectReplayableGames(result, 0);
+}
+
+TEST_F(TarokStateTests, TestRandomGamesWithFourPlayers) {
+  auto result = PlayRandomGames(300, 1, 1, 4, true);
+  EXPECT_EQ(result.returns.size(), 300 * 4);
+  ExpectReplayableGames(result, 1);
+}
+
+TEST_F(TarokStateTests, TestRandomGamesDontDependOnThreads) {
+  auto result = PlayRandomGames(1000, 0, 1, 3);
+  auto threaded_result = PlayRandomGames(1000, 0, 3, 3);
+  EXPECT_TRUE(result.histories.empty());
+  EXPECT_EQ(threaded_result.contracts, result.contracts);
+  EXPECT_EQ(threaded_result.returns, result.returns);
+  EXPECT_EQ(threaded_result.game_lengths, result.game_lengths);
+  EXPECT_NE(PlayRandomGames(1000, 1, 1, 3).returns, result.returns);
+}
+
+}  // namespace tarok
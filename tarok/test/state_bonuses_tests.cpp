@@ -0,0 +1,109 @@
+/* Copyright 2020 Semantic Weights. All rights reserved. */
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "test/state_tests.h"
+#include "test/tarok_utils.h"
+
+namespace tarok {
+
+TEST_F(TarokStateTests, TestKingsCollectedByDeclarer) {
+  // all four kings collected by the declarer playing two, 45 card points
+  auto state = StateAfterActions(
+      open_spiel::GameParameters({{"seed", open_spiel::GameParameter(23)}}),
+      {kDealCardsAction, 0, 0, 3, 0, 24, 49, 11, 20, 16, 48, 52, 1, 4, 15, 3,
+       28, 26, 22, 38, 40, 44, 5, 8, 18, 12, 9, 14, 50, 53, 0, 17, 21, 2, 43,
+       45, 13, 23, 19, 25, 51, 47, 10, 6, 41, 36, 35, 33, 31, 29, 46, 37, 30,
+       39, 34});
+  EXPECT_TRUE(state->IsTerminal());
+  // 45 - 35 + 20 for the contract + 10 for the kings
+  EXPECT_THAT(state->ScoresWithoutCapturedMondPenalties(),
+              testing::ElementsAre(40, 0, 0));
+}
+
+TEST_F(TarokStateTests, TestKingsCollectedByOpponents) {
+  // all four kings collected by the opponents of the declarer playing two
+  auto state = StateAfterActions(
+      open_spiel::GameParameters({{"seed", open_spiel::GameParameter(166)}}),
+      {kDealCardsAction, 3, 0, 0, 3, 1, 51, 33, 12, 14, 3, 44, 38, 42, 36, 30,
+       32, 28, 27, 26, 50, 46, 52, 24, 22, 21, 37, 15, 9, 7, 11, 19, 31, 5, 13,
+       18, 4, 20, 29, 25, 6, 34, 8, 1, 10, 48, 17, 45, 43, 39, 40, 23, 49, 2,
+       47, 53});
+  EXPECT_TRUE(state->IsTerminal());
+  // 21 - 35 - 20 for the contract - 10 for the kings
+  EXPECT_THAT(state->ScoresWithoutCapturedMondPenalties(),
+              testing::ElementsAre(0, -44, 0));
+}
+
+TEST_F(TarokStateTests, TestTrulaCollectedByDeclarer) {
+  // the trula collected by the declarer playing one
+  auto state = StateAfterActions(
+      open_spiel::GameParameters({{"seed", open_spiel::GameParameter(231)}}),
+      {kDealCardsAction, 0, 0, 4, 4, 40, 6, 17, 15, 39, 41, 45, 13, 19, 11, 26,
+       22, 24, 5, 18, 2, 33, 32, 37, 38, 16, 43, 51, 7, 46, 30, 31, 36, 49, 0,
+       52, 4, 10, 35, 12, 28, 8, 23, 25, 3, 20, 1, 29, 21, 9, 50, 42, 44, 53});
+  EXPECT_TRUE(state->IsTerminal());
+  // 32 - 35 - 30 for the contract + 10 for the trula
+  EXPECT_THAT(state->ScoresWithoutCapturedMondPenalties(),
+              testing::ElementsAre(-23, 0, 0));
+}
+
+TEST_F(TarokStateTests, TestTrulaCollectedByOpponents) {
+  // the trula collected by the opponents of the declarer playing one
+  auto state = StateAfterActions(
+      open_spiel::GameParameters({{"seed", open_spiel::GameParameter(20)}}),
+      {kDealCardsAction, 4, 0, 0, 4, 0, 39, 4, 2, 21, 15, 19, 13, 18, 12, 20,
+       3, 1, 6, 49, 5, 52, 17, 0, 16, 9, 14, 44, 30, 34, 31, 35, 32, 37, 46,
+       47, 10, 45, 42, 43, 23, 25, 29, 26, 24, 11, 41, 48, 8, 33, 36, 50, 53,
+       27, 28});
+  EXPECT_TRUE(state->IsTerminal());
+  // 8 - 35 - 30 for the contract - 10 for the trula
+  EXPECT_THAT(state->ScoresWithoutCapturedMondPenalties(),
+              testing::ElementsAre(0, -67, 0));
+}
+
+TEST_F(TarokStateTests, TestKingUltimo) {
+  // the declarer's partner wins the last trick with the called king of spades
+  auto state = StateAfterActions(
+      open_spiel::GameParameters({{"num_players", open_spiel::GameParameter(4)},
+                                  {"seed", open_spiel::GameParameter(63)}}),
+      {kDealCardsAction, 0, 0, 4, 0, 4, 45, 1, 34, 32, 36, 30, 37, 7, 3, 8, 20,
+       52, 47, 14, 46, 25, 28, 15, 5, 49, 53, 17, 50, 31, 1, 33, 35, 24, 11, 0,
+       26, 19, 16, 12, 21, 2, 10, 9, 44, 43, 38, 41, 23, 48, 40, 29, 22, 45,
+       39, 42, 27});
+  EXPECT_TRUE(state->IsTerminal());
+  // 47 - 35 + 30 for the contract + 10 for the king ultimo
+  EXPECT_THAT(state->ScoresWithoutCapturedMondPenalties(),
+              testing::ElementsAre(0, 0, 52, 52));
+}
+
+TEST_F(TarokStateTests, TestPagatUltimo) {
+  // pagat is played in the last trick which an opponent of the declarer playing
+  // two wins
+  auto state = StateAfterActions(
+      open_spiel::GameParameters({{"seed", open_spiel::GameParameter(732)}}),
+      {kDealCardsAction, 3, 0, 0, 3, 2, 26, 46, 4, 11, 15, 22, 29, 28, 47, 48,
+       50, 31, 32, 33, 36, 30, 34, 13, 3, 19, 52, 7, 53, 43, 45, 42, 10, 20,
+       18, 2, 6, 5, 27, 12, 23, 41, 44, 38, 51, 16, 9, 37, 35, 14, 39, 25, 40,
+       0, 17, 24});
+  EXPECT_TRUE(state->IsTerminal());
+  // 20 - 35 - 20 for the contract - 25 for the pagat ultimo
+  EXPECT_THAT(state->ScoresWithoutCapturedMondPenalties(),
+              testing::ElementsAre(0, -60, 0));
+}
+
+TEST_F(TarokStateTests, TestKlopTalonGifts) {
+  // talon cards are gifted to the winners of the first six tricks in klop so
+  // they count towards their points and all 70 points are scored
+  auto state = StateAfterActions(
+      open_spiel::GameParameters({{"seed", open_spiel::GameParameter(1)}}),
+      {kDealCardsAction, 0, 0, 1, 27, 29, 23, 32, 34, 36, 28, 25, 24, 33, 12,
+       30, 18, 20, 6, 15, 19, 21, 45, 40, 43, 51, 53, 52, 11, 13, 14, 10, 16,
+       2, 1, 38, 3, 5, 9, 22, 50, 49, 48, 7, 37, 47, 8, 39, 44, 26, 46, 42});
+  EXPECT_TRUE(state->IsTerminal());
+  EXPECT_EQ(state->SelectedContractName(), ContractName::kKlop);
+  EXPECT_THAT(state->ScoresWithoutCapturedMondPenalties(),
+              testing::ElementsAre(-16, -23, -31));
+}
+
+}  // namespace tarok
@@ -20,6 +20,7 @@ TEST_F(TarokStateTests, TestCardDealingPhase) {
   }
 
   EXPECT_THAT(state->LegalActions(), testing::ElementsAre(0));
+  EXPECT_EQ(state->LegalActionsBitmask(), 1);
   EXPECT_THAT(
       state->ChanceOutcomes(),
       testing::ElementsAreArray<open_spiel::ActionsAndProbs>({{0, 1.0}}));
@@ -0,0 +1,238 @@
+/* Copyright 2020 Semantic Weights. All rights reserved. */
+
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "test/state_tests.h"
+#include "test/tarok_utils.h"
+
+namespace tarok {
+
+static inline const open_spiel::GameParameters kGameParams =
+    open_spiel::GameParameters({{"num_players", open_spiel::GameParameter(3)},
+                                {"seed", open_spiel::GameParameter(634317)}});
+
+TEST_F(TarokStateTests, TestInfoStatesInKlop) {
+  auto state = StateAfterActions(
+      kGameParams, {kDealCardsAction, kBidPassAction, kBidPassAction,
+                    kBidKlopAction, 1, 2, 5, 8});
+  // the gift talon card is part of the first trick
+  EXPECT_EQ(state->InformationStateString(0),
+            "1,3,4,7,10,18,20,26,27,30,39,42,45,49,50,51;0,0,1;1,2,5,28;8,");
+  EXPECT_EQ(state->InformationStateString(1),
+            "2,6,11,12,13,19,21,25,31,35,36,37,38,43,47,52;0,0,1;1,2,5,28;8,");
+  EXPECT_EQ(state->InformationStateString(2),
+            "0,5,8,9,14,15,16,17,22,32,33,34,40,41,48,53;0,0,1;1,2,5,28;8,");
+}
+
+TEST_F(TarokStateTests, TestInfoStatesInTalonExchange) {
+  auto state = StateAfterActions(
+      kGameParams, {kDealCardsAction, kBidPassAction, kBidPassAction,
+                    kBidThreeAction, 1, 26, 27, 44});
+  // only the declarer knows about the discarded non-tarok cards
+  EXPECT_EQ(state->InformationStateString(0),
+            "1,3,4,7,10,18,20,26,27,30,39,42,45,49,50,51;0,0,2;"
+            "28,24,23,44,46,29;1;26,27,44;");
+  EXPECT_EQ(state->InformationStateString(1),
+            "2,6,11,12,13,19,21,25,31,35,36,37,38,43,47,52;0,0,2;"
+            "28,24,23,44,46,29;1;");
+
+  // info states are rendered from the history so clones have to match
+  auto clone = state->Clone();
+  for (int i = 0; i < 3; i++) {
+    EXPECT_EQ(clone->InformationStateString(i),
+              state->InformationStateString(i));
+  }
+  state->ApplyAction(state->LegalActions().front());
+  EXPECT_NE(clone->InformationStateString(1),
+            state->InformationStateString(1));
+}
+
+// info state keys have to identify info states, i.e. map different info state
+// strings to different keys and the same strings to the same keys
+static void ExpectInfoStateKeysIdentifyInfoStates(int num_players) {
+  auto game = NewTarokGame(open_spiel::GameParameters(
+      {{"num_players", open_spiel::GameParameter(num_players)},
+       {"seed", open_spiel::GameParameter(0)}}));
+  std::mt19937 rng(0);
+  std::map<std::string, uint64_t> keys;
+  std::map<uint64_t, std::string> info_states;
+  for (int deal = 0; deal < 50; deal++) {
+    auto state = game->NewInitialTarokState(deal % 10);
+    while (!state->IsTerminal()) {
+      for (int i = 0; i < num_players; i++) {
+        std::string info_state = state->InformationStateString(i);
+        uint64_t key = state->InformationStateKey(i);
+        EXPECT_EQ(keys.emplace(info_state, key).first->second, key);
+        EXPECT_EQ(info_states.emplace(key, info_state).first->second,
+                  info_state);
+      }
+      auto legal_actions = state->LegalActions();
+      state->ApplyAction(legal_actions.at(rng() % legal_actions.size()));
+    }
+  }
+}
+
+TEST_F(TarokStateTests, TestInfoStateKeysWithThreePlayers) {
+  ExpectInfoStateKeysIdentifyInfoStates(3);
+}
+
+TEST_F(TarokStateTests, TestInfoStateKeysWithFourPlayers) {
+  ExpectInfoStateKeysIdentifyInfoStates(4);
+}
+
+// offsets of the info state tensor parts for three players, see
+// TarokState::InformationStateTensor() for the layout
+static constexpr int kTensorHandOffset = 3;
+static constexpr int kTensorBidsOffset = 57;
+static constexpr int kTensorTalonOffset = 100;
+static constexpr int kTensorTalonSetOffset = 154;
+static constexpr int kTensorDiscardedOffset = 208;
+static constexpr int kTensorTricksOffset = 262;
+static constexpr int kTensorTrickSize = 165;
+
+static std::vector<float> InfoStateTensor(const TarokState& state,
+                                          open_spiel::Player player) {
+  std::vector<float> values(
+      NewTarokGame(kGameParams)->InformationStateTensorSize());
+  state.InformationStateTensor(player, absl::MakeSpan(values));
+  return values;
+}
+
+static std::vector<open_spiel::Action> EncodedCards(
+    const std::vector<float>& values, int offset) {
+  std::vector<open_spiel::Action> cards;
+  for (int i = 0; i < 54; i++) {
+    if (values.at(offset + i) == 1) cards.push_back(i);
+  }
+  return cards;
+}
+
+TEST_F(TarokStateTests, TestInfoStateTensorsInTalonExchange) {
+  EXPECT_EQ(NewTarokGame(kGameParams)
+                ->InformationStateTensorShape(),
+            std::vector<int>{2902});
+
+  auto state = StateAfterActions(
+      kGameParams, {kDealCardsAction, kBidPassAction, kBidPassAction,
+                    kBidThreeAction, 1, 26, 27, 44});
+  auto values = InfoStateTensor(*state, 0);
+  EXPECT_EQ(values.at(0), 1);
+  EXPECT_EQ(EncodedCards(values, kTensorHandOffset),
+            std::vector<open_spiel::Action>(
+                {1, 3, 4, 7, 10, 18, 20, 26, 27, 30, 39, 42, 45, 49, 50, 51}));
+  EXPECT_EQ(values.at(kTensorBidsOffset + kBidThreeAction), 1);
+  EXPECT_EQ(values.at(kTensorBidsOffset + 13 + kBidPassAction), 1);
+  EXPECT_EQ(values.at(kTensorBidsOffset + 26 + kBidPassAction), 1);
+  EXPECT_EQ(EncodedCards(values, kTensorTalonOffset),
+            std::vector<open_spiel::Action>({23, 24, 28, 29, 44, 46}));
+  EXPECT_EQ(EncodedCards(values, kTensorTalonSetOffset),
+            std::vector<open_spiel::Action>({29, 44, 46}));
+  EXPECT_EQ(EncodedCards(values, kTensorDiscardedOffset),
+            std::vector<open_spiel::Action>({26, 27, 44}));
+
+  // only the declarer knows about the discarded non-tarok cards
+  values = InfoStateTensor(*state, 1);
+  EXPECT_EQ(values.at(1), 1);
+  EXPECT_EQ(EncodedCards(values, kTensorTalonSetOffset),
+            std::vector<open_spiel::Action>({29, 44, 46}));
+  EXPECT_TRUE(EncodedCards(values, kTensorDiscardedOffset).empty());
+  for (size_t i = kTensorTricksOffset; i < values.size(); i++) {
+    EXPECT_EQ(values.at(i), 0);
+  }
+}
+
+TEST_F(TarokStateTests, TestInfoStateTensorsEncodeTricks) {
+  // all tricks are always played in klop
+  auto state = StateAfterActions(
+      kGameParams,
+      {kDealCardsAction, kBidPassAction, kBidPassAction, kBidKlopAction});
+  std::mt19937 rng(0);
+  std::vector<std::tuple<open_spiel::Player, open_spiel::Action>> played;
+  while (!state->IsTerminal()) {
+    auto legal_actions = state->LegalActions();
+    open_spiel::Action action =
+        legal_actions.at(rng() % legal_actions.size());
+    played.push_back({state->CurrentPlayer(), action});
+    state->ApplyAction(action);
+  }
+
+  // each trick is encoded with its opener and cards per player
+  auto values = InfoStateTensor(*state, 2);
+  int num_encoded = 0;
+  for (size_t i = kTensorTricksOffset; i < values.size(); i++) {
+    num_encoded += values.at(i);
+  }
+  EXPECT_EQ(num_encoded, 16 + played.size());
+  EXPECT_EQ(played.size(), 48);
+  for (size_t i = 0; i < played.size(); i++) {
+    auto [player, action] = played.at(i);
+    int trick_offset = kTensorTricksOffset + (i / 3) * kTensorTrickSize;
+    if (i % 3 == 0) {
+      EXPECT_EQ(values.at(trick_offset + player), 1);
+    }
+    EXPECT_EQ(values.at(trick_offset + 3 + player * 54 + action), 1);
+  }
+}
+
+// offsets of the observation tensor parts for three players, see
+// TarokState::ObservationTensor() for the layout
+static constexpr int kObservationBidsOffset = 54;
+static constexpr int kObservationContractOffset = 93;
+static constexpr int kObservationPartnerOffset = 108;
+static constexpr int kObservationTrickOffset = 112;
+static constexpr int kObservationPlayedOffset = 274;
+static constexpr int kObservationPointsOffset = 436;
+
+static std::vector<float> ObservationTensor(const TarokState& state,
+                                            open_spiel::Player player) {
+  std::vector<float> values(
+      NewTarokGame(kGameParams)->ObservationTensorSize());
+  state.ObservationTensor(player, absl::MakeSpan(values));
+  return values;
+}
+
+TEST_F(TarokStateTests, TestObservationTensorsInKlop) {
+  EXPECT_EQ(NewTarokGame(kGameParams)->ObservationTensorShape(),
+            std::vector<int>{439});
+
+  auto state = StateAfterActions(
+      kGameParams, {kDealCardsAction, kBidPassAction, kBidPassAction,
+                    kBidKlopAction, 1, 2});
+  // players are encoded relative to the observing player
+  auto values = ObservationTensor(*state, 2);
+  EXPECT_EQ(EncodedCards(values, 0),
+            std::vector<open_spiel::Action>(
+                {0, 5, 8, 9, 14, 15, 16, 17, 22, 32, 33, 34, 40, 41, 48, 53}));
+  EXPECT_EQ(values.at(kObservationBidsOffset + kBidPassAction), 1);
+  EXPECT_EQ(values.at(kObservationBidsOffset + 13 + kBidKlopAction), 1);
+  EXPECT_EQ(values.at(kObservationBidsOffset + 26 + kBidPassAction), 1);
+  EXPECT_EQ(values.at(kObservationContractOffset), 1);
+  EXPECT_EQ(values.at(kObservationPartnerOffset), 0);
+  EXPECT_EQ(EncodedCards(values, kObservationTrickOffset + 54),
+            std::vector<open_spiel::Action>({1}));
+  EXPECT_EQ(EncodedCards(values, kObservationTrickOffset + 108),
+            std::vector<open_spiel::Action>({2}));
+  EXPECT_EQ(EncodedCards(values, kObservationPlayedOffset + 108),
+            std::vector<open_spiel::Action>({2}));
+
+  // the trick is resolved and collected together with the gift talon card
+  state->ApplyAction(5);
+  values = ObservationTensor(*state, 2);
+  EXPECT_TRUE(EncodedCards(values, kObservationTrickOffset).empty());
+  EXPECT_EQ(EncodedCards(values, kObservationPlayedOffset),
+            std::vector<open_spiel::Action>({5}));
+  EXPECT_FLOAT_EQ(values.at(kObservationPointsOffset), 4 / 70.0);
+  EXPECT_EQ(values.at(kObservationPointsOffset + 1), 0);
+
+  // the same state is observed from a different seat
+  values = ObservationTensor(*state, 0);
+  EXPECT_EQ(EncodedCards(values, kObservationPlayedOffset + 108),
+            std::vector<open_spiel::Action>({5}));
+  EXPECT_FLOAT_EQ(values.at(kObservationPointsOffset + 2), 4 / 70.0);
+}
+
+}  // namespace tarok
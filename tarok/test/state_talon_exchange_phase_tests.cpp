@@ -257,4 +257,50 @@ TEST_F(TarokStateTests, TestTalonExchangePhase8) {
   EXPECT_EQ(state->CurrentGamePhase(), GamePhase::kTricksPlaying);
 }
 
+TEST_F(TarokStateTests, TestTalonExchangePhaseInferences) {
+  // check card holders as the talon is shown and cards are discarded
+  auto state = StateAfterActions(
+      open_spiel::GameParameters({{"num_players", open_spiel::GameParameter(4)},
+                                  {"seed", open_spiel::GameParameter(141750)}}),
+      {kDealCardsAction, kBidPassAction, kBidPassAction, kBidPassAction,
+       kBidSoloTwoAction});
+  open_spiel::Player declarer = state->CurrentPlayer();
+  auto talon_sets = state->TalonSets();
+  // the talon is shown to all players
+  for (auto const& action : state->Talon())
+    EXPECT_EQ(state->PossibleCardHolders(action), 0);
+
+  // only the declarer holds the selected talon set
+  state->ApplyAction(0);
+  for (auto const& action : talon_sets.at(0))
+    EXPECT_EQ(state->PossibleCardHolders(action), 1 << declarer);
+  for (auto const& action : talon_sets.at(1))
+    EXPECT_EQ(state->PossibleCardHolders(action), 0);
+
+  // discarded taroks are shown and leave the declarer with taroks and kings
+  open_spiel::Action discarded_action = state->LegalActions().at(0);
+  uint8_t discarded_holders = state->PossibleCardHolders(discarded_action);
+  state->ApplyAction(discarded_action);
+  EXPECT_EQ(state->PossibleCardHolders(discarded_action), discarded_holders);
+  open_spiel::Action discarded_tarok = state->LegalActions().at(0);
+  state->ApplyAction(discarded_tarok);
+  EXPECT_EQ(state->PossibleCardHolders(discarded_tarok), 0);
+  EXPECT_FALSE(state->IsPubliclyVoidInSuit(declarer, CardSuit::kTaroks));
+  for (auto const& suit : {CardSuit::kHearts, CardSuit::kDiamonds,
+                           CardSuit::kSpades, CardSuit::kClubs}) {
+    EXPECT_EQ(state->PubliclyExcludedCards(declarer) & SuitToCardSet(suit) &
+                  ~kKingsCardSet,
+              SuitToCardSet(suit) & ~kKingsCardSet);
+  }
+
+  // undoing the discards also undoes the inferences
+  state->UndoAction(declarer, discarded_tarok);
+  state->UndoAction(declarer, discarded_action);
+  EXPECT_NE(state->PossibleCardHolders(discarded_tarok), 0);
+  EXPECT_EQ(state->PossibleCardHolders(discarded_action), discarded_holders);
+  state->UndoAction(declarer, 0);
+  for (auto const& action : state->Talon())
+    EXPECT_EQ(state->PossibleCardHolders(action), 0);
+}
+
 }  // namespace tarok
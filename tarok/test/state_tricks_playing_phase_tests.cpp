@@ -303,4 +303,94 @@ TEST_F(TarokStateTests, TestTricksPlayingPhase7) {
   EXPECT_TRUE(state->TrickCards().empty());
 }
 
+TEST_F(TarokStateTests, TestTricksPlayingPhaseVoids) {
+  // check inferred voids and card holders in klop
+  auto state = StateAfterActions(kGameParams, {kDealCardsAction, kBidPassAction,
+                                               kBidPassAction, kBidKlopAction});
+  // the queen and king of hearts are in talon
+  EXPECT_EQ(state->PossibleCardHolders(28), 0b111);
+  EXPECT_EQ(state->PossibleCardHolders(29), 0b111);
+  // jack of hearts is followed by lower hearts
+  state->ApplyAction(26);
+  state->ApplyAction(25);
+  state->ApplyAction(22);
+  EXPECT_EQ(state->PossibleCardHolders(29), 0b001);
+  // played and gifted cards aren't held by anyone
+  EXPECT_EQ(state->PossibleCardHolders(26), 0);
+  EXPECT_EQ(state->PossibleCardHolders(28), 0);
+  EXPECT_FALSE(state->IsPubliclyVoidInSuit(1, CardSuit::kHearts));
+  EXPECT_FALSE(state->IsPubliclyVoidInSuit(2, CardSuit::kHearts));
+
+  // knight of hearts is followed by taroks
+  EXPECT_EQ(state->CurrentPlayer(), 0);
+  state->ApplyAction(27);
+  state->ApplyAction(2);
+  state->ApplyAction(5);
+  for (int i = 1; i < 3; i++) {
+    EXPECT_TRUE(state->IsPubliclyVoidInSuit(i, CardSuit::kHearts));
+    EXPECT_FALSE(state->IsPubliclyVoidInSuit(i, CardSuit::kTaroks));
+    EXPECT_EQ(state->PubliclyExcludedCards(i) & ActionsToCardSet(
+                                                    state->PlayerCards(i)),
+              kEmptyCardSet);
+  }
+  EXPECT_FALSE(state->IsPubliclyVoidInSuit(0, CardSuit::kHearts));
+
+  // undoing the plays also undoes the inferences
+  state->UndoAction(2, 5);
+  state->UndoAction(1, 2);
+  EXPECT_FALSE(state->IsPubliclyVoidInSuit(1, CardSuit::kHearts));
+  EXPECT_EQ(state->PossibleCardHolders(29), 0b001);
+  state->UndoAction(0, 27);
+  state->UndoAction(2, 22);
+  state->UndoAction(1, 25);
+  EXPECT_EQ(state->PossibleCardHolders(28), 0b111);
+  EXPECT_EQ(state->PossibleCardHolders(29), 0b111);
+}
+
+TEST_F(TarokStateTests, TestTricksPlayingPhaseTransposition) {
+  // check that the same tricks played in different order lead to equal states
+  auto state = StateAfterActions(kGameParams, {kDealCardsAction, kBidPassAction,
+                                               kBidPassAction, kBidKlopAction});
+  auto other_state = state->Clone();
+  auto& other = static_cast<TarokState&>(*other_state);
+  EXPECT_TRUE(*state == other);
+
+  // player 0 wins both tricks in either order
+  for (auto const& action : {45, 38, 40, 27, 25, 22})
+    state->ApplyAction(action);
+  for (auto const& action : {27, 25, 22, 45, 38, 40})
+    other.ApplyAction(action);
+  // the last trick differs
+  EXPECT_TRUE(*state != other);
+  for (auto const& action : {26, 2, 5}) {
+    state->ApplyAction(action);
+    other.ApplyAction(action);
+  }
+  EXPECT_EQ(state->CurrentPlayer(), 2);
+  EXPECT_NE(state->History(), other.History());
+  EXPECT_TRUE(*state == other);
+  EXPECT_EQ(state->Hash(), other.Hash());
+
+  other.UndoAction(2, 5);
+  EXPECT_TRUE(*state != other);
+  EXPECT_NE(state->Hash(), other.Hash());
+}
+
+TEST_F(TarokStateTests, TestTrustedActionsMatchCheckedActions) {
+  auto state = StateAfterActions(kGameParams, {kDealCardsAction});
+  // clone the dealt state to play the same game twice
+  std::unique_ptr<TarokState> trusted_state(
+      static_cast<TarokState*>(state->Clone().release()));
+
+  while (!state->IsTerminal()) {
+    open_spiel::Action action = state->LegalActions().back();
+    state->ApplyAction(action);
+    trusted_state->ApplyTrustedAction(action);
+    EXPECT_EQ(state->History(), trusted_state->History());
+    EXPECT_EQ(state->ToString(), trusted_state->ToString());
+  }
+  EXPECT_TRUE(trusted_state->IsTerminal());
+  EXPECT_EQ(state->Returns(), trusted_state->Returns());
+}
+
 }  // namespace tarok
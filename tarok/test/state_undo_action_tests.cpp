@@ -0,0 +1,117 @@
+/* Copyright 2020 Semantic Weights. All rights reserved. */
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "test/state_tests.h"
+#include "test/tarok_utils.h"
+
+namespace tarok {
+
+// compares states through everything that is observable via their interface
+static void ExpectEqualStates(const TarokGame& game, const TarokState& state,
+                              const TarokState& other_state) {
+  EXPECT_EQ(state.History(), other_state.History());
+  EXPECT_EQ(state.ToString(), other_state.ToString());
+  EXPECT_EQ(state.LegalActionsBitmask(), other_state.LegalActionsBitmask());
+  EXPECT_EQ(state.Talon(), other_state.Talon());
+  EXPECT_EQ(state.CapturedMondPenalties(), other_state.CapturedMondPenalties());
+  EXPECT_EQ(state.Hash(), other_state.Hash());
+  EXPECT_TRUE(state == other_state);
+  for (int i = 0; i < 54; i++) {
+    EXPECT_EQ(state.PossibleCardHolders(i), other_state.PossibleCardHolders(i));
+  }
+
+  std::vector<float> values(game.InformationStateTensorSize());
+  std::vector<float> other_values(game.InformationStateTensorSize());
+  std::vector<float> observation(game.ObservationTensorSize());
+  std::vector<float> other_observation(game.ObservationTensorSize());
+  for (int i = 0; i < game.NumPlayers(); i++) {
+    EXPECT_EQ(state.InformationStateString(i),
+              other_state.InformationStateString(i));
+    state.InformationStateTensor(i, absl::MakeSpan(values));
+    other_state.InformationStateTensor(i, absl::MakeSpan(other_values));
+    EXPECT_EQ(values, other_values);
+    state.ObservationTensor(i, absl::MakeSpan(observation));
+    other_state.ObservationTensor(i, absl::MakeSpan(other_observation));
+    EXPECT_EQ(observation, other_observation);
+    EXPECT_EQ(state.PubliclyExcludedCards(i),
+              other_state.PubliclyExcludedCards(i));
+    EXPECT_EQ(state.InformationStateKey(i),
+              other_state.InformationStateKey(i));
+  }
+}
+
+static void UndoActionsInRandomGames(int num_players) {
+  auto game = NewTarokGame(open_spiel::GameParameters(
+      {{"num_players", open_spiel::GameParameter(num_players)},
+       {"seed", open_spiel::GameParameter(0)}}));
+  std::mt19937 rng(0);
+
+  for (int i = 0; i < 100; i++) {
+    auto state = game->NewInitialTarokState();
+    while (!state->IsTerminal()) {
+      auto legal_actions = state->LegalActions();
+      int num_choices = legal_actions.size();
+      // bid low to reach klop and king calling contracts more often
+      if (state->CurrentGamePhase() == GamePhase::kBidding)
+        num_choices = std::min(num_choices, 2);
+      open_spiel::Action action = legal_actions.at(rng() % num_choices);
+      open_spiel::Player player = state->CurrentPlayer();
+
+      auto clone = state->Clone();
+      state->ApplyAction(action);
+      auto applied_clone = state->Clone();
+      state->UndoAction(player, action);
+      ExpectEqualStates(*game, *state, static_cast<TarokState&>(*clone));
+
+      // the state has to behave the same after redoing the action, including
+      // the card dealing since states keep their deal seed
+      state->ApplyAction(action);
+      ExpectEqualStates(*game, *state,
+                        static_cast<TarokState&>(*applied_clone));
+    }
+  }
+}
+
+TEST_F(TarokStateTests, TestUndoActionsInRandomGamesWithThreePlayers) {
+  UndoActionsInRandomGames(3);
+}
+
+TEST_F(TarokStateTests, TestUndoActionsInRandomGamesWithFourPlayers) {
+  UndoActionsInRandomGames(4);
+}
+
+TEST_F(TarokStateTests, TestUndoActionRestoresCapturedMond) {
+  auto state = StateAfterActions(
+      open_spiel::GameParameters({{"seed", open_spiel::GameParameter(634317)}}),
+      {kDealCardsAction, kBidPassAction, kBidPassAction, kBidOneAction, 0, 49,
+       CardLongNameToAction("Mond", deck_),
+       CardLongNameToAction("Skis", deck_)});
+  // mond is captured by skis once the trick is resolved
+  open_spiel::Action action = CardLongNameToAction("VI", deck_);
+  state->ApplyAction(action);
+  EXPECT_EQ(state->CapturedMondPenalties(), std::vector<int>({-20, 0, 0}));
+  state->UndoAction(2, action);
+  EXPECT_EQ(state->CapturedMondPenalties(), std::vector<int>({0, 0, 0}));
+  EXPECT_EQ(state->TrickCards(),
+            CardLongNamesToActions({"Mond", "Skis"}, deck_));
+  EXPECT_EQ(state->CurrentPlayer(), 2);
+}
+
+TEST_F(TarokStateTests, TestUndoActionRestoresKlopTalon) {
+  auto state = StateAfterActions(
+      open_spiel::GameParameters({{"seed", open_spiel::GameParameter(634317)}}),
+      {kDealCardsAction, kBidPassAction, kBidPassAction, kBidKlopAction, 1, 2});
+  auto talon = state->Talon();
+  // the first talon card is gifted to the trick winner
+  state->ApplyAction(5);
+  EXPECT_EQ(state->Talon().size(), 5);
+  state->UndoAction(2, 5);
+  EXPECT_EQ(state->Talon(), talon);
+  EXPECT_EQ(state->TrickCards(), std::vector<open_spiel::Action>({1, 2}));
+}
+
+}  // namespace tarok
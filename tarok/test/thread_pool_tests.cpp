@@ -0,0 +1,38 @@
+/* Copyright 2020 Semantic Weights. All rights reserved. */
+
+#include <atomic>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "src/thread_pool.h"
+
+namespace tarok {
+
+TEST(ThreadPoolTests, TestEveryTaskRunsOnce) {
+  ThreadPool pool(4);
+  std::vector<std::atomic<int>> num_runs(1000);
+  for (int i = 0; i < 100; i++) {
+    pool.Submit([&, i]() {
+      num_runs.at(i)++;
+      // tasks submitted from within a task go to the running thread's queue
+      // and are stolen by the other threads
+      for (int j = 1; j < 10; j++) {
+        pool.Submit([&, i, j]() { num_runs.at(j * 100 + i)++; });
+      }
+    });
+  }
+  pool.Wait();
+  for (auto const& runs : num_runs) EXPECT_EQ(runs, 1);
+}
+
+TEST(ThreadPoolTests, TestWaitingRepeatedly) {
+  ThreadPool pool(3);
+  std::atomic<int> num_runs = 0;
+  for (int i = 1; i <= 5; i++) {
+    for (int j = 0; j < 10; j++) pool.Submit([&]() { num_runs++; });
+    pool.Wait();
+    EXPECT_EQ(num_runs, i * 10);
+  }
+}
+
+}  // namespace tarok
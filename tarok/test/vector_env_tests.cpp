@@ -0,0 +1,106 @@
+/* Copyright 2020 Semantic Weights. All rights reserved. */
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "src/game.h"
+#include "src/vector_env.h"
+#include "test/state_tests.h"
+#include "test/tarok_utils.h"
+
+namespace tarok {
+
+// games of the environment have to be played the same as separately created
+// states that are dealt the same deals in the same order
+static void StepRandomGames(int num_players) {
+  auto params = open_spiel::GameParameters(
+      {{"num_players", open_spiel::GameParameter(num_players)},
+       {"seed", open_spiel::GameParameter(0)}});
+  auto game = NewTarokGame(params);
+  auto other_game = NewTarokGame(params);
+  constexpr int kNumEnvs = 8;
+  TarokVectorEnv env(game, kNumEnvs);
+  int num_actions = game->NumDistinctActions();
+  int tensor_size = game->InformationStateTensorSize();
+
+  std::vector<std::unique_ptr<TarokState>> states;
+  int num_deals = 0;
+  auto deal = [&]() {
+    auto state = other_game->NewInitialTarokState(num_deals++);
+    state->ApplyAction(kDealCardsAction);
+    return state;
+  };
+  for (int i = 0; i < kNumEnvs; i++) states.push_back(deal());
+
+  std::mt19937 rng(0);
+  int num_finished_games = 0;
+  std::vector<float> tensor(tensor_size);
+  for (int step = 0; step < 1000; step++) {
+    for (int i = 0; i < kNumEnvs; i++) {
+      const TarokState& state = *states.at(i);
+      EXPECT_EQ(env.State(i).ToString(), state.ToString());
+      EXPECT_EQ(env.CurrentPlayers().at(i), state.CurrentPlayer());
+      ActionBitmask legal_actions = state.LegalActionsBitmask();
+      for (int j = 0; j < num_actions; j++) {
+        EXPECT_EQ(env.LegalActionsMasks().at(i * num_actions + j),
+                  (legal_actions >> j) & 1);
+      }
+      state.InformationStateTensor(state.CurrentPlayer(),
+                                   absl::MakeSpan(tensor));
+      EXPECT_TRUE(std::equal(tensor.begin(), tensor.end(),
+                             env.InformationStateTensors().begin() +
+                                 i * tensor_size));
+    }
+
+    std::vector<open_spiel::Action> actions;
+    for (int i = 0; i < kNumEnvs; i++) {
+      auto legal_actions = states.at(i)->LegalActions();
+      actions.push_back(legal_actions.at(rng() % legal_actions.size()));
+    }
+    env.Step(actions);
+    for (int i = 0; i < kNumEnvs; i++) {
+      states.at(i)->ApplyAction(actions.at(i));
+      std::vector<double> rewards(
+          env.Rewards().begin() + i * num_players,
+          env.Rewards().begin() + (i + 1) * num_players);
+      EXPECT_EQ(env.Dones().at(i), states.at(i)->IsTerminal());
+      if (states.at(i)->IsTerminal()) {
+        EXPECT_EQ(rewards, states.at(i)->Returns());
+        states.at(i) = deal();
+        num_finished_games++;
+      } else {
+        EXPECT_EQ(rewards, std::vector<double>(num_players, 0));
+      }
+    }
+  }
+  EXPECT_GT(num_finished_games, kNumEnvs);
+}
+
+TEST_F(TarokStateTests, TestVectorEnvWithThreePlayers) { StepRandomGames(3); }
+
+TEST_F(TarokStateTests, TestVectorEnvWithFourPlayers) { StepRandomGames(4); }
+
+TEST_F(TarokStateTests, TestVectorEnvReset) {
+  auto params =
+      open_spiel::GameParameters({{"seed", open_spiel::GameParameter(0)}});
+  auto game = NewTarokGame(params);
+  TarokVectorEnv env(game, 2);
+  env.Step({env.State(0).LegalActions().front(),
+            env.State(1).LegalActions().front()});
+  env.Reset();
+  // all games are dealt the next deals of the game and start with bidding
+  for (int i = 0; i < 2; i++) {
+    EXPECT_EQ(env.State(i).CurrentGamePhase(), GamePhase::kBidding);
+    EXPECT_EQ(env.State(i).History().size(), 1);
+    EXPECT_EQ(env.Dones().at(i), 0);
+    auto state = NewTarokGame(params)->NewInitialTarokState(2 + i);
+    state->ApplyAction(kDealCardsAction);
+    EXPECT_TRUE(env.State(i) == *state);
+    EXPECT_EQ(env.State(i).ToString(), state->ToString());
+  }
+}
+
+}  // namespace tarok